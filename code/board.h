@@ -0,0 +1,50 @@
+#ifndef ZADANIE2_BOARD_H
+#define ZADANIE2_BOARD_H
+
+#include <cstdint>
+#include <vector>
+
+// Bit per pixel, row-major, sized to the actual game area.
+// clear() only zeroes the words written since the previous clear.
+class Board {
+    uint32_t width, height;
+    std::vector<uint64_t> words;
+    std::vector<uint32_t> touched; // words which became non-zero since last clear
+
+    [[nodiscard]] uint64_t index(uint32_t x, uint32_t y) const {
+        return (uint64_t) y * width + x;
+    }
+
+public:
+    Board(uint32_t width, uint32_t height) : width(width), height(height),
+                                             words(((uint64_t) width * height + 63) / 64), touched() {}
+
+    [[nodiscard]] uint32_t get_width() const {
+        return width;
+    }
+
+    [[nodiscard]] uint32_t get_height() const {
+        return height;
+    }
+
+    [[nodiscard]] bool eaten(uint32_t x, uint32_t y) const {
+        uint64_t i = index(x, y);
+        return (words[i / 64] >> (i % 64)) & 1;
+    }
+
+    void eat(uint32_t x, uint32_t y) {
+        uint64_t i = index(x, y);
+        uint64_t &word = words[i / 64];
+        if (word == 0)
+            touched.push_back(i / 64);
+        word |= (uint64_t) 1 << (i % 64);
+    }
+
+    void clear() {
+        for (uint32_t w : touched)
+            words[w] = 0;
+        touched.clear();
+    }
+};
+
+#endif //ZADANIE2_BOARD_H
@@ -35,6 +35,29 @@ using client_to_serwer_mess = struct __attribute__((__packed__)) client_to_serwe
 
 #define CLIENT_HEADER_SIZE 13
 
+/* Protocol versions. A v1 client sends just the name. A v2 client follows the name with
+ * a zero byte and the extension below, which v1 servers reject as a bad name. Fields missing
+ * at the end of the extension count as zeros. */
+
+#define PROTOCOL_V1 1
+#define PROTOCOL_V2 2
+
+using client_extension_mess = struct __attribute__((__packed__)) client_extension {
+    uint8_t protocol_version;
+    uint8_t flags;
+    uint32_t gap_end; // client has events from here on, but misses the ones before, 0 if it has none
+};
+
+#define CLIENT_COMPACT 1 // v2 events in compact datagrams
+#define CLIENT_LOCKSTEP 2 // inputs of every round instead of their events, client simulates the game
+#define CLIENT_SNAPSHOTS 4 // understands SNAPSHOT events, gets them when catching up
+
+#define MAX_PLAYERS_V1 256
+#define MAX_PLAYERS_V2 65536
+
+// longest datagram from a client, with room for the extension to grow
+#define MAX_CLIENT_MESS_LEN 64
+
 using event_header_mess =  struct __attribute__((__packed__)) event_header {
     uint32_t len;
     uint32_t event_no;
@@ -56,6 +79,15 @@ using new_game_data_mess = struct __attribute__((__packed__)) new_game_data {
 
 #define NEW_GAME_EVENT_MINIMUMLEN (8 + EVENT_NO_TYPE_SIZE)
 
+// v2: player count follows the size, names which don't fit in a datagram come in PLAYER_NAMES events
+using new_game_data_v2_mess = struct __attribute__((__packed__)) new_game_data_v2 {
+    uint32_t maxx;
+    uint32_t maxy;
+    uint32_t players_count;
+};
+
+#define NEW_GAME_V2_EVENT_MINIMUMLEN (12 + EVENT_NO_TYPE_SIZE)
+
 #define PIXEL_TYPE 1
 
 using pixel_data_mess = struct __attribute__((__packed__)) pixel_data {
@@ -66,6 +98,14 @@ using pixel_data_mess = struct __attribute__((__packed__)) pixel_data {
 
 #define PIXEL_DATA_LEN (9 + EVENT_NO_TYPE_SIZE)
 
+using pixel_data_v2_mess = struct __attribute__((__packed__)) pixel_data_v2 {
+    uint16_t player_number;
+    uint32_t x;
+    uint32_t y;
+};
+
+#define PIXEL_DATA_V2_LEN (10 + EVENT_NO_TYPE_SIZE)
+
 #define ELIMINATED_TYPE 2
 
 using eliminated_data_mess = struct __attribute__((__packed__)) eliminated_data {
@@ -74,8 +114,55 @@ using eliminated_data_mess = struct __attribute__((__packed__)) eliminated_data
 
 #define ELIMINATED_DATA_LEN (1 + EVENT_NO_TYPE_SIZE)
 
+using eliminated_data_v2_mess = struct __attribute__((__packed__)) eliminated_data_v2 {
+    uint16_t player_number;
+};
+
+#define ELIMINATED_DATA_V2_LEN (2 + EVENT_NO_TYPE_SIZE)
+
 #define END_GAME_TYPE 3
 
 #define END_GAME_DATA_LEN EVENT_NO_TYPE_SIZE
 
+// v2 only: names of further players, right after NEW_GAME
+#define PLAYER_NAMES_TYPE 4
+
+/* v2 only: picture of the game before event event_no, which a client catching up gets instead
+ * of the events before it (but after the names). It is cut into fragments, all of them with
+ * the same event_no and outside of the numbering of events. Fragments joined in order are
+ * varints: count and numbers of eliminated players, count of worms with their last pixels
+ * (player number, x, y), then up to the end runs of pixels eaten by one player in row-major
+ * order (pixels skipped since the previous run, length, player number). */
+#define SNAPSHOT_TYPE 5
+
+using snapshot_data_mess = struct __attribute__((__packed__)) snapshot_data {
+    uint32_t fragment_no;
+    uint32_t fragments_count;
+};
+
+/* Compact datagrams: game id, header, records of consecutive events, crc of header and records.
+ * Record is a tag byte, for PIXEL_TYPE and ELIMINATED_TYPE followed by the player number and
+ * for PIXEL_TYPE also x and y, for NEW_GAME_TYPE and PLAYER_NAMES_TYPE by the length of data
+ * and v2 data. Numbers are varints (7 bits per byte, lowest first). A pixel next to previous
+ * pixel of the worm has only the player number after tag COMPACT_PIXEL_STEP + 3 * (dx + 1) + (dy + 1). */
+
+#define COMPACT_MARKER 0xC0
+#define COMPACT_PIXEL_STEP 0x10
+
+using compact_header_mess = struct __attribute__((__packed__)) compact_header {
+    uint8_t marker;
+    uint32_t first_event_no;
+};
+
+/* Lockstep datagrams are framed like compact ones. Their records are NEW_GAME_TYPE and
+ * PLAYER_NAMES_TYPE as in compact datagrams, then rules and start of every worm in player
+ * order, then ticks with inputs of every round with a hash of the state now and then,
+ * and END_GAME_TYPE. */
+
+#define LOCKSTEP_MARKER 0xC1
+#define LOCKSTEP_RULES 0x20 // turning speed
+#define LOCKSTEP_WORM 0x21 // x, y and direction of the next worm
+#define LOCKSTEP_TICK 0x22 // length and turn directions of all worms, 2 bits each, from the lowest bits
+#define LOCKSTEP_HASH 0x23 // ticks so far and state_hash after them (4 bytes, big endian)
+
 #endif //ZADANIE2_COMMUNICATION_H
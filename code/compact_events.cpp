@@ -0,0 +1,108 @@
+#include <cstring>
+#include <endian.h>
+#include "compact_events.h"
+
+void RecordStream::clear() {
+    records.clear();
+    datagrams.clear();
+    kept = false;
+}
+
+void RecordStream::append_with_data(uint8_t tag, const void *data, uint32_t len) {
+    record.resize(1 + MAX_VARINT_LEN + len);
+    record[0] = tag;
+    uint8_t *end = write_varint(record.data() + 1, len);
+    memcpy(end, data, len);
+    records.append_record(record.data(), end - record.data() + len);
+}
+
+void RecordStream::append_numbers(uint8_t tag, std::initializer_list<uint32_t> numbers) {
+    uint8_t buffer[1 + 4 * MAX_VARINT_LEN];
+    buffer[0] = tag;
+    uint8_t *end = buffer + 1;
+    for (uint32_t number : numbers)
+        end = write_varint(end, number);
+    records.append_record(buffer, end - buffer);
+}
+
+void RecordStream::new_game(const void *data, uint32_t len) {
+    append_with_data(NEW_GAME_TYPE, data, len);
+}
+
+void RecordStream::player_names(const void *data, uint32_t len) {
+    append_with_data(PLAYER_NAMES_TYPE, data, len);
+}
+
+void RecordStream::end_game() {
+    uint8_t tag = END_GAME_TYPE;
+    records.append_record(&tag, 1);
+}
+
+CompactDatagram RecordStream::make_datagram(const EventSlice &slice) const {
+    CompactDatagram datagram{{marker, htobe32(slice.first)}, slice, 0};
+    crc32_t rem = crc_update(crc_start(), (const uint8_t *) &datagram.header, sizeof datagram.header);
+    rem = crc_update(rem, datagram.records.data, datagram.records.len);
+    datagram.crc = htobe32(crc_finish(rem));
+    return datagram;
+}
+
+CompactDatagram RecordStream::datagram_from(uint32_t first) const {
+    return make_datagram(records.slice(first, COMPACT_RECORDS_LEN));
+}
+
+CompactDatagram RecordStream::datagram(uint32_t first) {
+    return datagrams.get(records, first, COMPACT_RECORDS_LEN,
+                         [this](const EventSlice &slice) { return make_datagram(slice); });
+}
+
+void CompactStream::clear() {
+    RecordStream::clear();
+    last_pixels.clear();
+}
+
+void CompactStream::new_game(const void *data, uint32_t len, uint32_t players_count) {
+    last_pixels.assign(players_count, Pixel{0, 0, false});
+    RecordStream::new_game(data, len);
+}
+
+void CompactStream::pixel(uint32_t player, uint32_t x, uint32_t y) {
+    Pixel &last = last_pixels[player];
+    int64_t dx = (int64_t) x - last.x, dy = (int64_t) y - last.y;
+    if (last.known && -1 <= dx && dx <= 1 && -1 <= dy && dy <= 1)
+        append_numbers(COMPACT_PIXEL_STEP + 3 * (dx + 1) + (dy + 1), {player});
+    else
+        append_numbers(PIXEL_TYPE, {player, x, y});
+    last = {x, y, true};
+}
+
+void CompactStream::eliminated(uint32_t player) {
+    append_numbers(ELIMINATED_TYPE, {player});
+}
+
+bool LockstepStream::fits(uint32_t players_count) {
+    return 1 + MAX_VARINT_LEN + (players_count + 3) / 4 < COMPACT_RECORDS_LEN;
+}
+
+void LockstepStream::rules(uint32_t turning_speed) {
+    append_numbers(LOCKSTEP_RULES, {turning_speed});
+}
+
+void LockstepStream::worm(uint32_t x, uint32_t y, int32_t direction) {
+    append_numbers(LOCKSTEP_WORM, {x, y, (uint32_t) direction});
+}
+
+void LockstepStream::tick(const std::vector<uint8_t> &turn_directions) {
+    inputs.assign((turn_directions.size() + 3) / 4, 0);
+    for (size_t i = 0; i < turn_directions.size(); i++)
+        inputs[i / 4] |= turn_directions[i] << (2 * (i % 4));
+    append_with_data(LOCKSTEP_TICK, inputs.data(), inputs.size());
+}
+
+void LockstepStream::hash(uint32_t ticks, uint32_t state_hash) {
+    uint8_t buffer[1 + MAX_VARINT_LEN + sizeof(uint32_t)];
+    buffer[0] = LOCKSTEP_HASH;
+    uint8_t *end = write_varint(buffer + 1, ticks);
+    uint32_t hash_be = htobe32(state_hash);
+    memcpy(end, &hash_be, sizeof hash_be);
+    records.append_record(buffer, end + sizeof hash_be - buffer);
+}
@@ -0,0 +1,123 @@
+#ifndef ZADANIE2_COMPACT_EVENTS_H
+#define ZADANIE2_COMPACT_EVENTS_H
+
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+#include "communication.h"
+#include "crc.h"
+#include "event_log.h"
+
+#define MAX_VARINT_LEN 5
+
+inline uint8_t *write_varint(uint8_t *out, uint32_t value) {
+    while (value >= 0x80) {
+        *out++ = (value & 0x7f) | 0x80;
+        value >>= 7;
+    }
+    *out++ = value;
+    return out;
+}
+
+// false if the varint doesn't end before end
+inline bool read_varint(const uint8_t *&in, const uint8_t *end, uint32_t &value) {
+    value = 0;
+    for (int shift = 0; in < end && shift < 7 * MAX_VARINT_LEN; shift += 7) {
+        uint8_t byte = *in++;
+        value |= (uint32_t) (byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+// datagram after game id: header, records and crc (big endian), sent straight from the log
+struct CompactDatagram {
+    compact_header_mess header;
+    EventSlice records;
+    crc32_t crc;
+};
+
+// records after game id, header and crc
+#define COMPACT_RECORDS_LEN (MAX_HOST_MESS_LEN - sizeof(uint32_t) - sizeof(compact_header_mess) - sizeof(crc32_t))
+
+// Records of one game in compact datagrams, shared by all clients like in DatagramCache.
+class RecordStream {
+    uint8_t marker;
+
+    [[nodiscard]] CompactDatagram make_datagram(const EventSlice &slice) const;
+
+protected:
+    EventLog records;
+    std::vector<uint8_t> record;
+
+    void append_with_data(uint8_t tag, const void *data, uint32_t len);
+
+    void append_numbers(uint8_t tag, std::initializer_list<uint32_t> numbers);
+
+public:
+    bool kept = false;
+    DatagramCache<CompactDatagram> datagrams;
+
+    explicit RecordStream(uint8_t marker) : marker(marker) {}
+
+    [[nodiscard]] uint32_t size() const {
+        return records.size();
+    }
+
+    void clear();
+
+    void new_game(const void *data, uint32_t len);
+
+    void player_names(const void *data, uint32_t len);
+
+    void end_game();
+
+    // longest run of events starting with first which fits in a datagram, for the broadcast
+    [[nodiscard]] CompactDatagram datagram_from(uint32_t first) const;
+
+    // datagram with event first, from the cache
+    CompactDatagram datagram(uint32_t first);
+};
+
+// The v2 events of a game in the compact encoding. Event numbers are the same as in the v2 log.
+class CompactStream : public RecordStream {
+    struct Pixel {
+        uint32_t x, y;
+        bool known;
+    };
+
+    std::vector<Pixel> last_pixels; // of every worm, steps are encoded relative to them
+
+public:
+    CompactStream() : RecordStream(COMPACT_MARKER) {}
+
+    void clear();
+
+    void new_game(const void *data, uint32_t len, uint32_t players_count);
+
+    void pixel(uint32_t player, uint32_t x, uint32_t y);
+
+    void eliminated(uint32_t player);
+};
+
+// What lockstep clients need to play the game themselves.
+class LockstepStream : public RecordStream {
+    std::vector<uint8_t> inputs;
+
+public:
+    LockstepStream() : RecordStream(LOCKSTEP_MARKER) {}
+
+    // tick record of that many worms still fits in a datagram
+    static bool fits(uint32_t players_count);
+
+    void rules(uint32_t turning_speed);
+
+    void worm(uint32_t x, uint32_t y, int32_t direction);
+
+    void tick(const std::vector<uint8_t> &turn_directions);
+
+    void hash(uint32_t ticks, uint32_t state_hash);
+};
+
+#endif //ZADANIE2_COMPACT_EVENTS_H
@@ -0,0 +1,179 @@
+#ifndef ZADANIE2_CONNECTION_TABLE_H
+#define ZADANIE2_CONNECTION_TABLE_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+// client address normalized to IPv6 (IPv4 ones mapped) followed by port, network order
+struct ClientKey {
+    uint8_t bytes[18];
+
+    static ClientKey from(const sockaddr *addr) {
+        ClientKey key{};
+        if (addr->sa_family == AF_INET) {
+            auto *addr4 = (const sockaddr_in *) addr;
+            key.bytes[10] = key.bytes[11] = 0xff;
+            memcpy(key.bytes + 12, &addr4->sin_addr, 4);
+            memcpy(key.bytes + 16, &addr4->sin_port, 2);
+        } else {
+            auto *addr6 = (const sockaddr_in6 *) addr;
+            memcpy(key.bytes, &addr6->sin6_addr, 16);
+            memcpy(key.bytes + 16, &addr6->sin6_port, 2);
+        }
+        return key;
+    }
+
+    [[nodiscard]] sockaddr_in6 to_address() const {
+        sockaddr_in6 address{};
+        address.sin6_family = AF_INET6;
+        memcpy(&address.sin6_addr, bytes, 16);
+        memcpy(&address.sin6_port, bytes + 16, 2);
+        return address;
+    }
+
+    bool operator==(const ClientKey &k) const {
+        return memcmp(bytes, k.bytes, sizeof bytes) == 0;
+    }
+};
+
+struct Connection {
+    ClientKey key;
+    sockaddr_in6 address;
+    uint32_t player;
+};
+
+// Open addressing (linear probing, backward shift deletion) over a slab of connections
+// allocated up front, so neither lookups nor inserts allocate and lookup stays O(1).
+class ConnectionTable {
+    static constexpr uint32_t EMPTY = UINT32_MAX;
+
+    uint64_t seed;
+    std::vector<uint32_t> index; // slab positions, size is a power of two at least twice the capacity
+    std::vector<Connection> slab;
+    std::vector<uint32_t> free_entries;
+    std::vector<uint32_t> live; // taken slab positions, for iteration
+    std::vector<uint32_t> live_position;
+
+    static uint64_t mix(uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+    [[nodiscard]] size_t home(const ClientKey &key) const {
+        uint64_t high, low;
+        uint16_t port;
+        memcpy(&high, key.bytes, 8);
+        memcpy(&low, key.bytes + 8, 8);
+        memcpy(&port, key.bytes + 16, 2);
+        uint64_t hash = mix(mix(mix(seed ^ high) ^ low) ^ port);
+        return hash & (index.size() - 1);
+    }
+
+    [[nodiscard]] size_t position_of(const ClientKey &key) const {
+        size_t mask = index.size() - 1;
+        for (size_t i = home(key);; i = (i + 1) & mask) {
+            if (index[i] == EMPTY || slab[index[i]].key == key)
+                return i;
+        }
+    }
+
+public:
+    class iterator {
+        const uint32_t *entry;
+        Connection *slab;
+
+    public:
+        iterator(const uint32_t *entry, Connection *slab) : entry(entry), slab(slab) {}
+
+        Connection &operator*() const {
+            return slab[*entry];
+        }
+
+        iterator &operator++() {
+            ++entry;
+            return *this;
+        }
+
+        bool operator!=(const iterator &i) const {
+            return entry != i.entry;
+        }
+    };
+
+    ConnectionTable(uint32_t capacity, uint64_t seed) : seed(seed), index(), slab(capacity),
+                                                        free_entries(), live(), live_position(capacity) {
+        size_t size = 1;
+        while (size < 2 * (size_t) capacity)
+            size *= 2;
+        index.assign(size, EMPTY);
+        for (uint32_t i = capacity; i > 0; i--)
+            free_entries.push_back(i - 1);
+        live.reserve(capacity);
+    }
+
+    [[nodiscard]] size_t size() const {
+        return live.size();
+    }
+
+    [[nodiscard]] bool full() const {
+        return free_entries.empty();
+    }
+
+    Connection *find(const ClientKey &key) {
+        uint32_t entry = index[position_of(key)];
+        return entry == EMPTY ? nullptr : &slab[entry];
+    }
+
+    // key must not be in the table and the table must not be full
+    Connection &insert(const ClientKey &key, uint32_t player) {
+        uint32_t entry = free_entries.back();
+        free_entries.pop_back();
+        slab[entry] = {key, key.to_address(), player};
+        index[position_of(key)] = entry;
+        live_position[entry] = live.size();
+        live.push_back(entry);
+        return slab[entry];
+    }
+
+    void erase(const ClientKey &key) {
+        size_t mask = index.size() - 1;
+        size_t hole = position_of(key);
+        uint32_t entry = index[hole];
+        if (entry == EMPTY)
+            return;
+
+        // move later entries of the probe sequence into the hole, so no tombstones are needed
+        index[hole] = EMPTY;
+        for (size_t i = (hole + 1) & mask; index[i] != EMPTY; i = (i + 1) & mask) {
+            size_t wanted = home(slab[index[i]].key);
+            bool stays = hole <= i ? (hole < wanted && wanted <= i) : (hole < wanted || wanted <= i);
+            if (!stays) {
+                index[hole] = index[i];
+                index[i] = EMPTY;
+                hole = i;
+            }
+        }
+
+        uint32_t last = live.back();
+        live[live_position[entry]] = last;
+        live_position[last] = live_position[entry];
+        live.pop_back();
+        free_entries.push_back(entry);
+    }
+
+    iterator begin() {
+        return {live.data(), slab.data()};
+    }
+
+    iterator end() {
+        return {live.data() + live.size(), slab.data()};
+    }
+};
+
+#endif //ZADANIE2_CONNECTION_TABLE_H
@@ -1,20 +1,192 @@
 #include "crc.h"
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CRC_CLMUL
+#endif
+
 #define POLY_REV  0xEDB88320
 
-/* using wikipedia algorithm https://en.wikipedia.org/wiki/Computation_of_cyclic_redundancy_checks */
+/* remainders computed as in wikipedia algorithm https://en.wikipedia.org/wiki/Computation_of_cyclic_redundancy_checks
+ * and then used eight bytes at a time (slicing-by-8), or folded with carry-less multiplication
+ * (Intel "Fast CRC Computation Using PCLMULQDQ Instruction") where the processor has it */
 
-crc32_t crc_cacl(uint8_t message[], uint32_t size) {
-    crc32_t rem  = -1;
-    for (uint32_t i = 0; i < size; i++) {
-        rem  ^= message[i];
-        for (int j = 0; j < 8; j++) {
-            if (rem & 1) {
-                rem  = (rem >> 1) ^ POLY_REV;
-            } else {
-                rem  = rem >> 1;
+namespace {
+
+struct CrcTables {
+    crc32_t table[8][256];
+
+    CrcTables() : table() {
+        for (uint32_t i = 0; i < 256; i++) {
+            crc32_t rem = i;
+            for (int j = 0; j < 8; j++) {
+                if (rem & 1) {
+                    rem = (rem >> 1) ^ POLY_REV;
+                } else {
+                    rem = rem >> 1;
+                }
             }
+            table[0][i] = rem;
+        }
+        for (uint32_t i = 0; i < 256; i++) {
+            for (int t = 1; t < 8; t++)
+                table[t][i] = (table[t - 1][i] >> 8) ^ table[0][table[t - 1][i] & 0xff];
         }
     }
-    return ~rem;
-}
\ No newline at end of file
+};
+
+const CrcTables tables{};
+
+crc32_t crc_update_bytes(crc32_t rem, const uint8_t *data, size_t size) {
+    for (size_t i = 0; i < size; i++)
+        rem = (rem >> 8) ^ tables.table[0][(rem ^ data[i]) & 0xff];
+    return rem;
+}
+
+crc32_t crc_update_slicing(crc32_t rem, const uint8_t *data, size_t size) {
+    auto &t = tables.table;
+    while (size >= 8) {
+        uint32_t low = rem ^ (data[0] | data[1] << 8 | data[2] << 16 | (uint32_t) data[3] << 24);
+        uint32_t high = data[4] | data[5] << 8 | data[6] << 16 | (uint32_t) data[7] << 24;
+        rem = t[7][low & 0xff] ^ t[6][(low >> 8) & 0xff] ^ t[5][(low >> 16) & 0xff] ^ t[4][low >> 24] ^
+              t[3][high & 0xff] ^ t[2][(high >> 8) & 0xff] ^ t[1][(high >> 16) & 0xff] ^ t[0][high >> 24];
+        data += 8;
+        size -= 8;
+    }
+    return crc_update_bytes(rem, data, size);
+}
+
+#ifdef CRC_CLMUL
+
+#define CLMUL_MIN_SIZE 64
+
+// folding constants of the reflected polynomial, from the Intel paper
+alignas(16) const uint64_t k1k2[] = {0x0154442bd4, 0x01c6e41596};
+alignas(16) const uint64_t k3k4[] = {0x01751997d0, 0x00ccaa009e};
+alignas(16) const uint64_t k5k0[] = {0x0163cd6124, 0x0000000000};
+alignas(16) const uint64_t poly[] = {0x01db710641, 0x01f7011641};
+
+// size has to be a multiple of 16, at least 64
+__attribute__((target("pclmul,sse4.1")))
+crc32_t crc_fold_clmul(crc32_t rem, const uint8_t *data, size_t size) {
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+    x1 = _mm_loadu_si128((const __m128i *) (data + 0x00));
+    x2 = _mm_loadu_si128((const __m128i *) (data + 0x10));
+    x3 = _mm_loadu_si128((const __m128i *) (data + 0x20));
+    x4 = _mm_loadu_si128((const __m128i *) (data + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(rem));
+    x0 = _mm_load_si128((const __m128i *) k1k2);
+    data += 64;
+    size -= 64;
+
+    // four blocks of 16 folded in parallel
+    while (size >= 64) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+        y5 = _mm_loadu_si128((const __m128i *) (data + 0x00));
+        y6 = _mm_loadu_si128((const __m128i *) (data + 0x10));
+        y7 = _mm_loadu_si128((const __m128i *) (data + 0x20));
+        y8 = _mm_loadu_si128((const __m128i *) (data + 0x30));
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+        data += 64;
+        size -= 64;
+    }
+
+    // fold into 128 bits
+    x0 = _mm_load_si128((const __m128i *) k3k4);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    while (size >= 16) {
+        x2 = _mm_loadu_si128((const __m128i *) data);
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+        data += 16;
+        size -= 16;
+    }
+
+    // fold 128 bits to 64
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_srli_si128(x1, 8);
+    x1 = _mm_xor_si128(x1, x2);
+    x0 = _mm_loadl_epi64((const __m128i *) k5k0);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, x3);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction to 32 bits
+    x0 = _mm_load_si128((const __m128i *) poly);
+    x2 = _mm_and_si128(x1, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+    return _mm_extract_epi32(x1, 1);
+}
+
+crc32_t crc_update_clmul(crc32_t rem, const uint8_t *data, size_t size) {
+    if (size >= CLMUL_MIN_SIZE) {
+        size_t folded = size & ~(size_t) 15;
+        rem = crc_fold_clmul(rem, data, folded);
+        data += folded;
+        size -= folded;
+    }
+    return crc_update_slicing(rem, data, size);
+}
+
+#endif
+
+using crc_update_fn = crc32_t (*)(crc32_t, const uint8_t *, size_t);
+
+crc_update_fn pick_implementation() {
+#ifdef CRC_CLMUL
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1"))
+        return crc_update_clmul;
+#endif
+    return crc_update_slicing;
+}
+
+crc_update_fn crc_update_impl = pick_implementation();
+
+}
+
+bool crc_uses_clmul() {
+#ifdef CRC_CLMUL
+    return crc_update_impl == crc_update_clmul;
+#else
+    return false;
+#endif
+}
+
+void crc_force_slicing() {
+    crc_update_impl = crc_update_slicing;
+}
+
+crc32_t crc_update(crc32_t rem, const uint8_t *data, size_t size) {
+    return crc_update_impl(rem, data, size);
+}
+
+crc32_t crc_cacl(uint8_t message[], uint32_t size) {
+    return crc_finish(crc_update(crc_start(), message, size));
+}
@@ -1,11 +1,30 @@
 #ifndef ZADANIE2_CRC_H
 #define ZADANIE2_CRC_H
 
+#include <cstddef>
 #include <cstdint>
 
 using crc32_t = uint32_t;
 
 crc32_t crc_cacl(uint8_t message[], uint32_t size);
 
+/* incremental version: crc_finish(crc_update(crc_start(), ...)) == crc_cacl(...) */
+
+inline crc32_t crc_start() {
+    return -1;
+}
+
+crc32_t crc_update(crc32_t rem, const uint8_t *data, size_t size);
+
+inline crc32_t crc_finish(crc32_t rem) {
+    return ~rem;
+}
+
+// whether crc_update folds with carry-less multiplication on this processor
+bool crc_uses_clmul();
+
+// makes crc_update use the portable slicing-by-8 tables from now on, so tests can check them
+void crc_force_slicing();
+
 
 #endif //ZADANIE2_CRC_H
@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <endian.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "event_log.h"
+#include "communication.h"
+#include "crc.h"
+#include "err.h"
+
+size_t EventLog::resident_limit = 0;
+
+namespace {
+    uint8_t *private_block(void *at) {
+        int flags = MAP_PRIVATE | MAP_ANONYMOUS | (at != nullptr ? MAP_FIXED : 0);
+        void *bytes = mmap(at, EVENT_LOG_BLOCK_SIZE, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (bytes == MAP_FAILED)
+            syserr("mmap");
+        return (uint8_t *) bytes;
+    }
+}
+
+EventLog::~EventLog() {
+    for (auto &block : blocks)
+        munmap(block.bytes, EVENT_LOG_BLOCK_SIZE);
+    for (auto bytes : spare)
+        munmap(bytes, EVENT_LOG_BLOCK_SIZE);
+    if (spill_fd >= 0)
+        close(spill_fd);
+}
+
+// room for an event of size len and its offset
+EventLog::Block &EventLog::block_for(uint32_t len) {
+    if (blocks.empty() ||
+        blocks.back().used + len + sizeof(uint16_t) * (blocks.back().events + 1) > EVENT_LOG_BLOCK_SIZE) {
+        if (resident_limit != 0 && blocks.size() - spilled >= resident_limit)
+            spill_oldest();
+        Block block{nullptr, 0, events, 0};
+        if (spare.empty()) {
+            block.bytes = private_block(nullptr);
+        } else {
+            block.bytes = spare.back();
+            spare.pop_back();
+        }
+        blocks.push_back(block);
+    }
+    return blocks.back();
+}
+
+// oldest block in memory goes to the spill file, which replaces its pages
+void EventLog::spill_oldest() {
+    if (spill_fd < 0) {
+        FILE *file = tmpfile();
+        if (file == nullptr)
+            syserr("tmpfile");
+        spill_fd = dup(fileno(file));
+        fclose(file);
+        if (spill_fd < 0)
+            syserr("dup");
+    }
+    Block &block = blocks[spilled];
+    off_t offset = (off_t) spilled * EVENT_LOG_BLOCK_SIZE;
+    if (pwrite(spill_fd, block.bytes, EVENT_LOG_BLOCK_SIZE, offset) != EVENT_LOG_BLOCK_SIZE)
+        syserr("spill write");
+    if (mmap(block.bytes, EVENT_LOG_BLOCK_SIZE, PROT_READ, MAP_SHARED | MAP_FIXED, spill_fd, offset) == MAP_FAILED)
+        syserr("mmap");
+    spilled++;
+}
+
+const EventLog::Block &EventLog::find_block(uint32_t event_no) const {
+    auto it = std::upper_bound(blocks.begin(), blocks.end(), event_no,
+                               [](uint32_t no, const Block &b) { return no < b.first_event; });
+    return *(it - 1);
+}
+
+// spilled blocks get fresh private pages, blocks beyond what the next game may keep in memory are unmapped
+void EventLog::clear() {
+    for (size_t i = blocks.size(); i-- > 0;) {
+        if (resident_limit != 0 && spare.size() >= resident_limit)
+            munmap(blocks[i].bytes, EVENT_LOG_BLOCK_SIZE);
+        else
+            spare.push_back(i < spilled ? private_block(blocks[i].bytes) : blocks[i].bytes);
+    }
+    if (spilled > 0 && ftruncate(spill_fd, 0) < 0)
+        syserr("ftruncate");
+    blocks.clear();
+    spilled = 0;
+    events = 0;
+}
+
+uint8_t *EventLog::push(uint32_t len) {
+    Block &block = block_for(len);
+    uint8_t *buffer = block.bytes + block.used;
+    ((uint16_t *) (block.bytes + EVENT_LOG_BLOCK_SIZE))[-1 - (ptrdiff_t) block.events] = block.used;
+    block.events++;
+    block.used += len;
+    events++;
+    return buffer;
+}
+
+void EventLog::append(uint8_t type, const void *data, uint32_t data_len) {
+    append_as(events, type, data, data_len);
+}
+
+void EventLog::append_as(uint32_t event_no, uint8_t type, const void *data, uint32_t data_len) {
+    uint8_t *buffer = push(data_len + EVENT_HEADER_META);
+
+    event_header_mess header(htobe32(data_len + EVENT_NO_TYPE_SIZE), htobe32(event_no), type);
+    memcpy(buffer, &header, EVENT_HEADER_SIZE);
+    crc32_t rem = crc_update(crc_start(), buffer, EVENT_HEADER_SIZE);
+    if (data_len != 0) // END_GAME has no data, memcpy from nullptr is undefined even then
+        memcpy(buffer + EVENT_HEADER_SIZE, data, data_len);
+    rem = crc_update(rem, buffer + EVENT_HEADER_SIZE, data_len);
+    crc32_t checksum = htobe32(crc_finish(rem));
+    memcpy(buffer + EVENT_HEADER_SIZE + data_len, &checksum, sizeof(crc32_t));
+}
+
+void EventLog::append_record(const void *record, uint32_t len) {
+    memcpy(push(len), record, len);
+}
+
+LoggedEvent EventLog::event(uint32_t event_no) const {
+    const Block &block = find_block(event_no);
+    uint32_t index = event_no - block.first_event;
+    uint32_t start = block.offset(index);
+    uint32_t end = index + 1 < block.events ? block.offset(index + 1) : block.used;
+    return {block.bytes[start + EVENT_HEADER_SIZE - 1], block.bytes + start + EVENT_HEADER_SIZE,
+            end - start - EVENT_HEADER_META};
+}
+
+EventSlice EventLog::slice(uint32_t first, uint32_t max_len) const {
+    if (first >= events)
+        return {nullptr, 0, first, 0};
+
+    const Block &block = find_block(first);
+    uint32_t index = first - block.first_event;
+    uint32_t start = block.offset(index);
+    uint32_t end = start;
+    uint32_t count = 0;
+    while (index + count < block.events) {
+        uint32_t next_end = index + count + 1 < block.events ? block.offset(index + count + 1) : block.used;
+        if (next_end - start >= max_len && count > 0)
+            break;
+        end = next_end;
+        count++;
+    }
+    return {block.bytes + start, end - start, first, count};
+}
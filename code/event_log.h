@@ -0,0 +1,155 @@
+#ifndef ZADANIE2_EVENT_LOG_H
+#define ZADANIE2_EVENT_LOG_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#define EVENT_LOG_BLOCK_SIZE (64 * 1024) // at most, offsets in a block take 16 bits
+
+// run of consecutive events, ready to be put on the wire after game id
+struct EventSlice {
+    const uint8_t *data;
+    uint32_t len;
+    uint32_t first; // number of the first event
+    uint32_t events;
+};
+
+// one event of a log, without its header and crc
+struct LoggedEvent {
+    uint8_t type;
+    const uint8_t *data;
+    uint32_t len;
+};
+
+// Events of one game stored back to back in their final wire format
+// (len, event_no, type, data, crc) in fixed-size blocks. Offsets of the events of a block are
+// at its end, the first one last, so the index is paged and spilled together with the events.
+// Events never span blocks, so any run of events inside a block is one contiguous slice.
+// Other encodings store their records as they are, numbered the same way.
+// Only the newest blocks stay in memory, older ones are written to a temporary file which is
+// mapped at the same addresses, so slices of them stay valid and the kernel pages them out.
+class EventLog {
+    struct Block {
+        uint8_t *bytes; // mapping of EVENT_LOG_BLOCK_SIZE bytes, private or of the spill file
+        uint32_t used; // by events, from the start
+        uint32_t first_event;
+        uint32_t events;
+
+        // offset of the event, there are events of them before the end of the block
+        [[nodiscard]] uint32_t offset(uint32_t index) const {
+            return ((const uint16_t *) (bytes + EVENT_LOG_BLOCK_SIZE))[-1 - (ptrdiff_t) index];
+        }
+    };
+
+    std::vector<Block> blocks;
+    std::vector<uint8_t *> spare; // blocks of previous games, reused
+    uint32_t events = 0;
+    size_t spilled = 0; // blocks in the spill file, they are the oldest ones
+    int spill_fd = -1; // opened with the first spilled block
+
+    Block &block_for(uint32_t len);
+
+    [[nodiscard]] const Block &find_block(uint32_t event_no) const;
+
+    // room for the next event of size len, which then counts as appended
+    uint8_t *push(uint32_t len);
+
+    void spill_oldest();
+
+public:
+    static size_t resident_limit; // blocks of one log kept in memory, 0 -> all of them
+
+    EventLog() = default;
+
+    EventLog(const EventLog &) = delete;
+
+    EventLog &operator=(const EventLog &) = delete;
+
+    ~EventLog();
+
+public:
+    [[nodiscard]] uint32_t size() const {
+        return events;
+    }
+
+    void clear();
+
+    // appends event with next number, data is the event specific part
+    void append(uint8_t type, const void *data, uint32_t data_len);
+
+    // appends event with given number, for logs of events outside of the numbering
+    void append_as(uint32_t event_no, uint8_t type, const void *data, uint32_t data_len);
+
+    // appends event already encoded, record must be shorter than a block
+    void append_record(const void *record, uint32_t len);
+
+    // event appended with append or append_as, which is in the log
+    [[nodiscard]] LoggedEvent event(uint32_t event_no) const;
+
+    // first event of the block with the event, datagrams never start before it
+    [[nodiscard]] uint32_t block_start(uint32_t event_no) const {
+        return find_block(event_no).first_event;
+    }
+
+    // longest run of events starting with first whose total size is less than max_len
+    // (but at least one event, so that oversized event can't stall the sender)
+    [[nodiscard]] EventSlice slice(uint32_t first, uint32_t max_len) const;
+};
+
+#define DATAGRAM_CACHE_BITS 5 // 32 datagrams kept by one cache
+
+// Datagrams cut from one game's log at fixed boundaries and shared by all clients: every block
+// starts with one, every next one starts where the previous one ended once that one couldn't grow.
+// Datagram asked for from any event starts at the boundary before it, so resends from different
+// events get the same datagrams. Only the latest datagrams and the boundaries in one block are kept.
+template<typename Datagram>
+class DatagramCache {
+    struct Entry {
+        uint32_t first = UINT32_MAX;
+        uint32_t log_size = 0;
+        bool full = false; // log went on after it, otherwise valid only for that log size
+        Datagram datagram{};
+    };
+
+    std::vector<uint32_t> cuts; // first events of datagrams, from the start of a block
+    std::array<Entry, 1 << DATAGRAM_CACHE_BITS> recent{}; // slot by a hash of the first event
+
+public:
+    uint64_t hits = 0, misses = 0;
+
+    // forgets datagrams, log is going to be cleared
+    void clear() {
+        cuts.clear();
+        recent.fill(Entry{});
+    }
+
+    // datagram with event first (which is in the log) made by make(slice)
+    template<typename Make>
+    Datagram get(const EventLog &log, uint32_t first, uint32_t max_len, Make make) {
+        uint32_t block = log.block_start(first);
+        if (cuts.empty() || cuts[0] != block)
+            cuts.assign(1, block);
+        while (cuts.back() <= first) {
+            EventSlice slice = log.slice(cuts.back(), max_len);
+            if (slice.first + slice.events >= log.size())
+                break;
+            cuts.push_back(slice.first + slice.events);
+        }
+        uint32_t start = *(std::upper_bound(cuts.begin(), cuts.end(), first) - 1);
+        Entry &entry = recent[(start * 0x9e3779b9u) >> (32 - DATAGRAM_CACHE_BITS)];
+        if (entry.first == start && (entry.full || entry.log_size == log.size())) {
+            hits++;
+            return entry.datagram;
+        }
+        misses++;
+        EventSlice slice = log.slice(start, max_len);
+        entry = {start, log.size(), slice.first + slice.events < log.size(), make(slice)};
+        return entry.datagram;
+    }
+};
+
+#endif //ZADANIE2_EVENT_LOG_H
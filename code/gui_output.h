@@ -0,0 +1,133 @@
+#ifndef ZADANIE2_GUI_OUTPUT_H
+#define ZADANIE2_GUI_OUTPUT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Lines for the GUI rendered straight into one buffer, which is reused once everything is written,
+// so formatting allocates nothing once the buffer grew to the size of a burst. Bytes from start
+// to used are waiting for the GUI, which may take them a part at a time.
+class GuiOutput {
+    static constexpr size_t NONE = SIZE_MAX;
+
+    std::vector<char> buffer;
+    size_t start = 0;
+    size_t used = 0;
+    size_t game_start = NONE; // the last NEW_GAME, NONE if there is none, not waiting unless after start
+    bool mid_line = false; // GUI got only a part of the first line waiting
+
+    char *reserve(size_t len) {
+        if (used + len > buffer.size() && start > 0) {
+            memmove(buffer.data(), buffer.data() + start, used - start);
+            used -= start;
+            game_start = game_start != NONE && game_start > start ? game_start - start : NONE;
+            start = 0;
+        }
+        if (used + len > buffer.size())
+            buffer.resize(std::max(2 * buffer.size(), used + len));
+        return buffer.data() + used;
+    }
+
+    void append(const char *text, size_t len) {
+        memcpy(reserve(len), text, len);
+        used += len;
+    }
+
+    template<size_t N>
+    void append(const char (&text)[N]) {
+        append(text, N - 1);
+    }
+
+    void append(const std::string &text) {
+        append(text.data(), text.size());
+    }
+
+    void append_number(uint32_t value) {
+        char digits[10];
+        size_t len = 0;
+        do {
+            digits[len++] = (char) ('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+        char *out = reserve(len);
+        for (size_t i = 0; i < len; i++)
+            out[i] = digits[len - 1 - i];
+        used += len;
+    }
+
+public:
+    GuiOutput() {
+        buffer.resize(4096);
+    }
+
+    void new_game(uint32_t maxx, uint32_t maxy, const std::vector<std::string> &names) {
+        game_start = used;
+        append("NEW_GAME ");
+        append_number(maxx);
+        append(" ");
+        append_number(maxy);
+        for (auto &name : names) {
+            append(" ");
+            append(name);
+        }
+        append("\n");
+    }
+
+    void pixel(uint32_t x, uint32_t y, const std::string &name) {
+        append("PIXEL ");
+        append_number(x);
+        append(" ");
+        append_number(y);
+        append(" ");
+        append(name);
+        append("\n");
+    }
+
+    void eliminated(const std::string &name) {
+        append("PLAYER_ELIMINATED ");
+        append(name);
+        append("\n");
+    }
+
+    [[nodiscard]] const char *data() const {
+        return buffer.data() + start;
+    }
+
+    [[nodiscard]] size_t size() const {
+        return used - start;
+    }
+
+    // len bytes from data() were written
+    void consume(size_t len) {
+        start += len;
+        if (start == used) {
+            start = used = 0;
+            game_start = NONE;
+        }
+        mid_line = start > 0 && buffer[start - 1] != '\n';
+    }
+
+    // Drops the lines of games followed by a NEW_GAME that is still waiting, as it clears the board
+    // anyway, except for the rest of a line already partly written. False if there were none.
+    bool skip_finished_games() {
+        if (game_start == NONE || game_start <= start)
+            return false;
+        if (mid_line) {
+            auto *line_end = (char *) memchr(buffer.data() + start, '\n', used - start);
+            size_t kept = line_end + 1 - buffer.data();
+            if (kept == game_start)
+                return false;
+            memmove(buffer.data() + kept, buffer.data() + game_start, used - game_start);
+            used -= game_start - kept;
+            game_start = kept;
+        } else {
+            start = game_start;
+        }
+        return true;
+    }
+};
+
+#endif //ZADANIE2_GUI_OUTPUT_H
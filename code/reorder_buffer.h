@@ -0,0 +1,78 @@
+#ifndef ZADANIE2_REORDER_BUFFER_H
+#define ZADANIE2_REORDER_BUFFER_H
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include "communication.h"
+
+#define REORDER_DATAGRAMS 64
+
+// Datagrams which came before the events they continue, whole (with game id), keyed by their
+// first event. They are parsed once the missing events arrive; when there is no room, the one
+// furthest ahead gives way, as it would wait longest.
+class ReorderBuffer {
+    struct Slot {
+        bool used;
+        uint32_t first_event;
+        int32_t size;
+        char bytes[MAX_HOST_MESS_LEN];
+    };
+
+    std::array<Slot, REORDER_DATAGRAMS> slots{};
+
+public:
+    // false if it wasn't kept, the same datagram is there or all kept ones are nearer
+    bool keep(uint32_t first_event, const char *datagram, int32_t size) {
+        Slot *free = nullptr, *furthest = nullptr;
+        for (auto &slot : slots) {
+            if (!slot.used) {
+                free = &slot;
+            } else if (slot.first_event == first_event) {
+                return false;
+            } else if (furthest == nullptr || slot.first_event > furthest->first_event) {
+                furthest = &slot;
+            }
+        }
+        if (free == nullptr) {
+            if (furthest->first_event < first_event)
+                return false;
+            free = furthest;
+        }
+        free->used = true;
+        free->first_event = first_event;
+        free->size = size;
+        memcpy(free->bytes, datagram, size);
+        return true;
+    }
+
+    // copies a kept datagram starting at or before next_event to buffer and forgets it,
+    // returns its size, -1 if there is none
+    int32_t take(uint32_t next_event, char *buffer) {
+        for (auto &slot : slots) {
+            if (slot.used && slot.first_event <= next_event) {
+                slot.used = false;
+                memcpy(buffer, slot.bytes, slot.size);
+                return slot.size;
+            }
+        }
+        return -1;
+    }
+
+    // first event of the nearest kept datagram, 0 if none is kept
+    [[nodiscard]] uint32_t gap_end() const {
+        uint32_t nearest = 0;
+        for (auto &slot : slots) {
+            if (slot.used && (nearest == 0 || slot.first_event < nearest))
+                nearest = slot.first_event;
+        }
+        return nearest;
+    }
+
+    void clear() {
+        for (auto &slot : slots)
+            slot.used = false;
+    }
+};
+
+#endif //ZADANIE2_REORDER_BUFFER_H
@@ -0,0 +1,172 @@
+#ifndef ZADANIE2_SEND_WINDOW_H
+#define ZADANIE2_SEND_WINDOW_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+// all times in microseconds
+#define RTO_INITIAL 100000
+#define RTO_MIN 20000 // heartbeats come every 20 ms, acknowledgements can't be faster
+#define RTO_MAX 1000000
+#define PACE_RATE 4 // bytes per microsecond to one client, on top of broadcasts
+#define PACE_BURST (64 * 1024)
+
+// Token bucket of bytes which may be sent to one client right now.
+class Pacer {
+    uint64_t tokens = PACE_BURST;
+    uint64_t refilled_at = 0;
+
+public:
+    void reset(uint64_t now) {
+        tokens = PACE_BURST;
+        refilled_at = now;
+    }
+
+    // false if there aren't len tokens, then nothing is taken
+    bool take(uint32_t len, uint64_t now) {
+        tokens = std::min<uint64_t>(PACE_BURST, tokens + (now - refilled_at) * PACE_RATE);
+        refilled_at = now;
+        if (tokens < len)
+            return false;
+        tokens -= len;
+        return true;
+    }
+};
+
+// Events of the current game sent to one client, as acknowledged by its heartbeats. Data in
+// flight is sent again only once it is older than the retransmission timeout, which comes from
+// round trips measured with heartbeats (smoothed like in TCP, RFC 6298).
+class SendWindow {
+    // events sent together, until end
+    struct Flight {
+        uint32_t end;
+        uint64_t sent_at;
+        bool again; // sent again
+        bool timed; // sent once at sent_at, so it measures a round trip (not when sent again, Karn)
+    };
+
+    static constexpr uint32_t MAX_FLIGHTS = 32; // more are merged into the newest one
+
+    uint32_t acked = 0; // client has all events before it
+    uint32_t sent = 0; // events before it were sent (again, if they are being sent again)
+    uint32_t highest = 0; // all events before it were sent at least once
+    uint32_t resend_until = 0; // events before it are being sent again
+    uint32_t hole_end = 0; // client has events from here on, but not the ones before, 0 -> no hole
+    std::array<Flight, MAX_FLIGHTS> flights{}; // events in flight, oldest first, a ring
+    uint32_t first_flight = 0, flights_count = 0;
+    uint64_t srtt = 0, rttvar = 0; // 0 until the first measurement
+    uint32_t fragments = 0; // of the snapshot before fragments_of, already sent
+    uint32_t fragments_of = 0;
+
+    Flight &flight(uint32_t i) {
+        return flights[(first_flight + i) % MAX_FLIGHTS];
+    }
+
+    void push_flight(uint32_t end, uint64_t now, bool again, bool timed) {
+        if (flights_count == MAX_FLIGHTS)
+            flight(flights_count - 1).end = end;
+        else
+            flight(flights_count++) = {end, now, again, timed};
+        sent = end;
+    }
+
+    void measured(uint64_t rtt) {
+        if (srtt == 0) {
+            srtt = rtt;
+            rttvar = rtt / 2;
+        } else {
+            uint64_t difference = srtt > rtt ? srtt - rtt : rtt - srtt;
+            rttvar = (3 * rttvar + difference) / 4;
+            srtt = (7 * srtt + rtt) / 8;
+        }
+    }
+
+public:
+    [[nodiscard]] uint32_t acknowledged() const {
+        return acked;
+    }
+
+    [[nodiscard]] uint32_t sent_until() const {
+        return sent;
+    }
+
+    [[nodiscard]] uint64_t rto() const {
+        return srtt == 0 ? RTO_INITIAL : std::clamp<uint64_t>(srtt + 4 * rttvar, RTO_MIN, RTO_MAX);
+    }
+
+    // new game, round trip estimate stays
+    void reset() {
+        acked = sent = highest = resend_until = hole_end = 0;
+        flights_count = 0;
+        fragments = fragments_of = 0;
+    }
+
+    // heartbeat asks for next_event and holds events from held_from on (0 if it doesn't say),
+    // asking for 0 again starts over (new game or lost state), other heartbeats asking for less
+    // are just late and ones asking for more than was sent are still about the previous game
+    // (heartbeats don't tell which game they are about)
+    void acknowledge(uint32_t next_event, uint32_t held_from, uint64_t now) {
+        if (next_event == 0 && acked > 0) {
+            reset();
+            return;
+        }
+        if (next_event < acked || next_event > highest)
+            return;
+        hole_end = held_from > next_event ? std::min(held_from, highest) : 0;
+        if (next_event == acked)
+            return;
+        while (flights_count > 0 && flight(0).end <= next_event) {
+            if (flight(0).timed)
+                measured(now - flight(0).sent_at);
+            first_flight = (first_flight + 1) % MAX_FLIGHTS;
+            flights_count--;
+        }
+        acked = next_event;
+        sent = std::max(sent, acked);
+    }
+
+    // data in flight is sent again when it looks lost: it is older than the timeout or the client
+    // reports a hole in what was sent just once (it got later datagrams, like TCP duplicate acks);
+    // or at once when there is no time to wait (finished game is replaced as soon as players are
+    // ready), true if it is; only heartbeats call it and they show the client is there, so there
+    // is no backoff; a client reporting a hole gets just the hole, sending goes on after what it
+    // has (unless in a hurry, holes after it would take another round trip)
+    bool retransmit_if_due(uint64_t now, bool hurry) {
+        if (acked >= highest)
+            return false;
+        bool lost = flights_count == 0 || now - flight(0).sent_at >= rto() || (hole_end > acked && !flight(0).again);
+        if (!hurry && !lost)
+            return false;
+        resend_until = hole_end > acked && !hurry ? hole_end : highest;
+        sent = acked;
+        flights_count = 0;
+        fragments = 0;
+        return true;
+    }
+
+    [[nodiscard]] bool resending(uint32_t event_no) const {
+        return event_no < resend_until;
+    }
+
+    void sent_to(uint32_t end, uint64_t now) {
+        if (end <= sent)
+            return;
+        bool again = sent < resend_until;
+        push_flight(end, now, again, !again);
+        if (sent >= resend_until && sent < highest) // hole filled, client has the rest
+            push_flight(highest, now, false, false);
+        highest = std::max(highest, sent);
+    }
+
+    // fragments of the snapshot before event_no already sent, they are counted from 0 for a new snapshot
+    uint32_t &fragments_sent(uint32_t event_no) {
+        if (fragments_of != event_no) {
+            fragments_of = event_no;
+            fragments = 0;
+        }
+        return fragments;
+    }
+};
+
+#endif //ZADANIE2_SEND_WINDOW_H
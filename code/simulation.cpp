@@ -0,0 +1,687 @@
+#include <cstring>
+#include "simulation.h"
+#include "communication.h"
+#include "crc.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/* unit vectors are the doubles cos(d * M_PI / 180.0) and sin(d * M_PI / 180.0) which the
+ * original version computed every round, written exactly as hexadecimal floats */
+
+#define UNIT(v) ((position_t) ((v) * 0x1p114))
+
+const position_t unit_cos[DIRECTIONS] = {
+        UNIT(0x1.ffec097f5af8ap-1), UNIT(0x1.ffb0278bf0567p-1), UNIT(0x1.ff4c5ed12e61dp-1),
+        UNIT(0x1.fec0b7170fff6p-1), UNIT(0x1.fe0d3b41815a2p-1), UNIT(0x1.fd31f94f867c6p-1),
+        UNIT(0x1.fc2f025a23e8cp-1), UNIT(0x1.fb046a9309479p-1), UNIT(0x1.f9b24942fe45bp-1),
+        UNIT(0x1.f838b8c811c17p-1), UNIT(0x1.f697d6938b6c2p-1), UNIT(0x1.f4cfc327a007fp-1),
+        UNIT(0x1.f2e0a214e870ep-1), UNIT(0x1.f0ca99f79ba25p-1), UNIT(0x1.ee8dd4748bf15p-1),
+        UNIT(0x1.ec2a7e35e7b80p-1), UNIT(0x1.e9a0c6e7bdb1ep-1), UNIT(0x1.e6f0e134454ffp-1),
+        UNIT(0x1.e41b02bfeb4cbp-1), UNIT(0x1.e11f642522d1cp-1), UNIT(0x1.ddfe40effb803p-1),
+        UNIT(0x1.dab7d7997cb57p-1), UNIT(0x1.d74c6982c666ep-1), UNIT(0x1.d3bc3aeff7f96p-1),
+        UNIT(0x1.d0079302dd768p-1), UNIT(0x1.cc2ebbb5638c8p-1), UNIT(0x1.c83201d3d2c6cp-1),
+        UNIT(0x1.c411b4f6d2707p-1), UNIT(0x1.bfce277d339c7p-1), UNIT(0x1.bb67ae8584ca8p-1),
+        UNIT(0x1.b6dea1e76eadcp-1), UNIT(0x1.b2335c2cda945p-1), UNIT(0x1.ad663a8ae2fdcp-1),
+        UNIT(0x1.a8779cda8eea6p-1), UNIT(0x1.a367e59158745p-1), UNIT(0x1.9e3779b97f4a7p-1),
+        UNIT(0x1.98e6c0ea27a14p-1), UNIT(0x1.9376253f463d2p-1), UNIT(0x1.8de613515a325p-1),
+        UNIT(0x1.8836fa2cf5037p-1), UNIT(0x1.82694b4a11c36p-1), UNIT(0x1.7c7d7a833bec2p-1),
+        UNIT(0x1.7673fe0c86984p-1), UNIT(0x1.704d4e6a54d36p-1), UNIT(0x1.6a09e667f3bcbp-1),
+        UNIT(0x1.63aa430e07310p-1), UNIT(0x1.5d2ee398c9c2cp-1), UNIT(0x1.5698496e20bd4p-1),
+        UNIT(0x1.4fe6f81384fd2p-1), UNIT(0x1.491b7523c161cp-1), UNIT(0x1.4236484487abep-1),
+        UNIT(0x1.3b37fb1bdc93bp-1), UNIT(0x1.342119455beb3p-1), UNIT(0x1.2cf2304755a5cp-1),
+        UNIT(0x1.25abcf87c4978p-1), UNIT(0x1.1e4e88411fd14p-1), UNIT(0x1.16daed7707719p-1),
+        UNIT(0x1.0f5193eacdd28p-1), UNIT(0x1.07b3120fddf13p-1), UNIT(0x1.0000000000001p-1),
+        UNIT(0x1.f071eedefa0f1p-2), UNIT(0x1.e0bd274245072p-2), UNIT(0x1.d0e2e2b44ddfep-2),
+        UNIT(0x1.c0e45dabe05c8p-2), UNIT(0x1.b0c2d77379856p-2), UNIT(0x1.a07f921061ac9p-2),
+        UNIT(0x1.901bd2298ffa6p-2), UNIT(0x1.7f98deee59680p-2), UNIT(0x1.6ef801fced33ep-2),
+        UNIT(0x1.5e3a8748a0bfap-2), UNIT(0x1.4d61bd000cdd5p-2), UNIT(0x1.3c6ef372fe94cp-2),
+        UNIT(0x1.2b637cf83d5c7p-2), UNIT(0x1.1a40add328e2dp-2), UNIT(0x1.0907dc1930688p-2),
+        UNIT(0x1.ef74bf2e4b913p-3), UNIT(0x1.ccb3236cdc672p-3), UNIT(0x1.a9cd9ac4258f9p-3),
+        UNIT(0x1.86c6ddd76625ap-3), UNIT(0x1.63a1a7e0b737cp-3), UNIT(0x1.4060b67a8536ep-3),
+        UNIT(0x1.1d06c968d9e1ap-3), UNIT(0x1.f32d44c4f62e2p-4), UNIT(0x1.ac2609b3c5749p-4),
+        UNIT(0x1.64fd6b8c280eep-4), UNIT(0x1.1db8f6d6a5122p-4), UNIT(0x1.acbc748efc91ep-5),
+        UNIT(0x1.1de58c9f7dc54p-5), UNIT(0x1.1df0b2b89dcb0p-6), UNIT(-0x1.a79394c9e8a0ap-53),
+        UNIT(-0x1.1df0b2b89dd1ap-6), UNIT(-0x1.1de58c9f7dc09p-5), UNIT(-0x1.acbc748efc952p-5),
+        UNIT(-0x1.1db8f6d6a513cp-4), UNIT(-0x1.64fd6b8c28108p-4), UNIT(-0x1.ac2609b3c5764p-4),
+        UNIT(-0x1.f32d44c4f62bdp-4), UNIT(-0x1.1d06c968d9e27p-3), UNIT(-0x1.4060b67a8537bp-3),
+        UNIT(-0x1.63a1a7e0b7389p-3), UNIT(-0x1.86c6ddd766248p-3), UNIT(-0x1.a9cd9ac425906p-3),
+        UNIT(-0x1.ccb3236cdc67ep-3), UNIT(-0x1.ef74bf2e4b91fp-3), UNIT(-0x1.0907dc193068ep-2),
+        UNIT(-0x1.1a40add328e24p-2), UNIT(-0x1.2b637cf83d5cep-2), UNIT(-0x1.3c6ef372fe952p-2),
+        UNIT(-0x1.4d61bd000cddbp-2), UNIT(-0x1.5e3a8748a0bf2p-2), UNIT(-0x1.6ef801fced344p-2),
+        UNIT(-0x1.7f98deee59686p-2), UNIT(-0x1.901bd2298ffacp-2), UNIT(-0x1.a07f921061acfp-2),
+        UNIT(-0x1.b0c2d7737984ep-2), UNIT(-0x1.c0e45dabe05cep-2), UNIT(-0x1.d0e2e2b44de03p-2),
+        UNIT(-0x1.e0bd274245078p-2), UNIT(-0x1.f071eedefa0e9p-2), UNIT(-0x1.0000000000004p-1),
+        UNIT(-0x1.07b3120fddf16p-1), UNIT(-0x1.0f5193eacdd2bp-1), UNIT(-0x1.16daed770771cp-1),
+        UNIT(-0x1.1e4e88411fd10p-1), UNIT(-0x1.25abcf87c497bp-1), UNIT(-0x1.2cf2304755a5fp-1),
+        UNIT(-0x1.342119455beb6p-1), UNIT(-0x1.3b37fb1bdc937p-1), UNIT(-0x1.4236484487ac1p-1),
+        UNIT(-0x1.491b7523c161ep-1), UNIT(-0x1.4fe6f81384fd4p-1), UNIT(-0x1.5698496e20bd7p-1),
+        UNIT(-0x1.5d2ee398c9c2cp-1), UNIT(-0x1.63aa430e07310p-1), UNIT(-0x1.6a09e667f3bcep-1),
+        UNIT(-0x1.704d4e6a54d38p-1), UNIT(-0x1.7673fe0c86983p-1), UNIT(-0x1.7c7d7a833bec2p-1),
+        UNIT(-0x1.82694b4a11c38p-1), UNIT(-0x1.8836fa2cf5039p-1), UNIT(-0x1.8de613515a327p-1),
+        UNIT(-0x1.9376253f463d2p-1), UNIT(-0x1.98e6c0ea27a14p-1), UNIT(-0x1.9e3779b97f4a9p-1),
+        UNIT(-0x1.a367e59158747p-1), UNIT(-0x1.a8779cda8eea6p-1), UNIT(-0x1.ad663a8ae2fdcp-1),
+        UNIT(-0x1.b2335c2cda946p-1), UNIT(-0x1.b6dea1e76eadep-1), UNIT(-0x1.bb67ae8584caap-1),
+        UNIT(-0x1.bfce277d339c7p-1), UNIT(-0x1.c411b4f6d2707p-1), UNIT(-0x1.c83201d3d2c6dp-1),
+        UNIT(-0x1.cc2ebbb5638c9p-1), UNIT(-0x1.d0079302dd768p-1), UNIT(-0x1.d3bc3aeff7f95p-1),
+        UNIT(-0x1.d74c6982c666fp-1), UNIT(-0x1.dab7d7997cb58p-1), UNIT(-0x1.ddfe40effb805p-1),
+        UNIT(-0x1.e11f642522d1cp-1), UNIT(-0x1.e41b02bfeb4cap-1), UNIT(-0x1.e6f0e13445500p-1),
+        UNIT(-0x1.e9a0c6e7bdb1fp-1), UNIT(-0x1.ec2a7e35e7b80p-1), UNIT(-0x1.ee8dd4748bf15p-1),
+        UNIT(-0x1.f0ca99f79ba25p-1), UNIT(-0x1.f2e0a214e870fp-1), UNIT(-0x1.f4cfc327a007fp-1),
+        UNIT(-0x1.f697d6938b6c2p-1), UNIT(-0x1.f838b8c811c17p-1), UNIT(-0x1.f9b24942fe45cp-1),
+        UNIT(-0x1.fb046a9309479p-1), UNIT(-0x1.fc2f025a23e8cp-1), UNIT(-0x1.fd31f94f867c6p-1),
+        UNIT(-0x1.fe0d3b41815a2p-1), UNIT(-0x1.fec0b7170fff6p-1), UNIT(-0x1.ff4c5ed12e61dp-1),
+        UNIT(-0x1.ffb0278bf0567p-1), UNIT(-0x1.ffec097f5af8ap-1), UNIT(-0x1.0000000000000p+0),
+        UNIT(-0x1.ffec097f5af8ap-1), UNIT(-0x1.ffb0278bf0567p-1), UNIT(-0x1.ff4c5ed12e61dp-1),
+        UNIT(-0x1.fec0b7170fff6p-1), UNIT(-0x1.fe0d3b41815a2p-1), UNIT(-0x1.fd31f94f867c6p-1),
+        UNIT(-0x1.fc2f025a23e8bp-1), UNIT(-0x1.fb046a930947ap-1), UNIT(-0x1.f9b24942fe45bp-1),
+        UNIT(-0x1.f838b8c811c17p-1), UNIT(-0x1.f697d6938b6c2p-1), UNIT(-0x1.f4cfc327a0080p-1),
+        UNIT(-0x1.f2e0a214e870ep-1), UNIT(-0x1.f0ca99f79ba25p-1), UNIT(-0x1.ee8dd4748bf14p-1),
+        UNIT(-0x1.ec2a7e35e7b80p-1), UNIT(-0x1.e9a0c6e7bdb20p-1), UNIT(-0x1.e6f0e134454ffp-1),
+        UNIT(-0x1.e41b02bfeb4cbp-1), UNIT(-0x1.e11f642522d1bp-1), UNIT(-0x1.ddfe40effb805p-1),
+        UNIT(-0x1.dab7d7997cb57p-1), UNIT(-0x1.d74c6982c666fp-1), UNIT(-0x1.d3bc3aeff7f94p-1),
+        UNIT(-0x1.d0079302dd767p-1), UNIT(-0x1.cc2ebbb5638cap-1), UNIT(-0x1.c83201d3d2c6cp-1),
+        UNIT(-0x1.c411b4f6d2708p-1), UNIT(-0x1.bfce277d339c6p-1), UNIT(-0x1.bb67ae8584cabp-1),
+        UNIT(-0x1.b6dea1e76eaddp-1), UNIT(-0x1.b2335c2cda945p-1), UNIT(-0x1.ad663a8ae2fdbp-1),
+        UNIT(-0x1.a8779cda8eea4p-1), UNIT(-0x1.a367e59158748p-1), UNIT(-0x1.9e3779b97f4a7p-1),
+        UNIT(-0x1.98e6c0ea27a15p-1), UNIT(-0x1.9376253f463d1p-1), UNIT(-0x1.8de613515a328p-1),
+        UNIT(-0x1.8836fa2cf5038p-1), UNIT(-0x1.82694b4a11c37p-1), UNIT(-0x1.7c7d7a833bec0p-1),
+        UNIT(-0x1.7673fe0c86982p-1), UNIT(-0x1.704d4e6a54d39p-1), UNIT(-0x1.6a09e667f3bccp-1),
+        UNIT(-0x1.63aa430e07311p-1), UNIT(-0x1.5d2ee398c9c2ap-1), UNIT(-0x1.5698496e20bd8p-1),
+        UNIT(-0x1.4fe6f81384fd3p-1), UNIT(-0x1.491b7523c161dp-1), UNIT(-0x1.4236484487abcp-1),
+        UNIT(-0x1.3b37fb1bdc939p-1), UNIT(-0x1.342119455beb7p-1), UNIT(-0x1.2cf2304755a5dp-1),
+        UNIT(-0x1.25abcf87c4979p-1), UNIT(-0x1.1e4e88411fd11p-1), UNIT(-0x1.16daed770771dp-1),
+        UNIT(-0x1.0f5193eacdd29p-1), UNIT(-0x1.07b3120fddf14p-1), UNIT(-0x1.ffffffffffffcp-2),
+        UNIT(-0x1.f071eedefa0ecp-2), UNIT(-0x1.e0bd27424507bp-2), UNIT(-0x1.d0e2e2b44ddffp-2),
+        UNIT(-0x1.c0e45dabe05cap-2), UNIT(-0x1.b0c2d77379851p-2), UNIT(-0x1.a07f921061ad2p-2),
+        UNIT(-0x1.901bd2298ffabp-2), UNIT(-0x1.7f98deee59682p-2), UNIT(-0x1.6ef801fced33cp-2),
+        UNIT(-0x1.5e3a8748a0bf5p-2), UNIT(-0x1.4d61bd000cddbp-2), UNIT(-0x1.3c6ef372fe94ep-2),
+        UNIT(-0x1.2b637cf83d5c6p-2), UNIT(-0x1.1a40add328e27p-2), UNIT(-0x1.0907dc1930692p-2),
+        UNIT(-0x1.ef74bf2e4b91fp-3), UNIT(-0x1.ccb3236cdc676p-3), UNIT(-0x1.a9cd9ac4258f6p-3),
+        UNIT(-0x1.86c6ddd76624fp-3), UNIT(-0x1.63a1a7e0b7388p-3), UNIT(-0x1.4060b67a85373p-3),
+        UNIT(-0x1.1d06c968d9e16p-3), UNIT(-0x1.f32d44c4f62cbp-4), UNIT(-0x1.ac2609b3c5772p-4),
+        UNIT(-0x1.64fd6b8c28107p-4), UNIT(-0x1.1db8f6d6a512ap-4), UNIT(-0x1.acbc748efc90fp-5),
+        UNIT(-0x1.1de58c9f7dc25p-5), UNIT(-0x1.1df0b2b89dd14p-6), UNIT(0x1.1a62633145c07p-54),
+        UNIT(0x1.1df0b2b89dd37p-6), UNIT(0x1.1de58c9f7dc37p-5), UNIT(0x1.acbc748efc921p-5),
+        UNIT(0x1.1db8f6d6a5123p-4), UNIT(0x1.64fd6b8c28100p-4), UNIT(0x1.ac2609b3c576bp-4),
+        UNIT(0x1.f32d44c4f62d4p-4), UNIT(0x1.1d06c968d9e1ap-3), UNIT(0x1.4060b67a85377p-3),
+        UNIT(0x1.63a1a7e0b738cp-3), UNIT(0x1.86c6ddd766253p-3), UNIT(0x1.a9cd9ac4258fap-3),
+        UNIT(0x1.ccb3236cdc672p-3), UNIT(0x1.ef74bf2e4b91bp-3), UNIT(0x1.0907dc1930690p-2),
+        UNIT(0x1.1a40add328e29p-2), UNIT(0x1.2b637cf83d5c8p-2), UNIT(0x1.3c6ef372fe950p-2),
+        UNIT(0x1.4d61bd000cdddp-2), UNIT(0x1.5e3a8748a0bf7p-2), UNIT(0x1.6ef801fced33ep-2),
+        UNIT(0x1.7f98deee59680p-2), UNIT(0x1.901bd2298ffaap-2), UNIT(0x1.a07f921061ad1p-2),
+        UNIT(0x1.b0c2d77379853p-2), UNIT(0x1.c0e45dabe05c9p-2), UNIT(0x1.d0e2e2b44de01p-2),
+        UNIT(0x1.e0bd27424507ap-2), UNIT(0x1.f071eedefa0eep-2), UNIT(0x1.0000000000001p-1),
+        UNIT(0x1.07b3120fddf13p-1), UNIT(0x1.0f5193eacdd2ap-1), UNIT(0x1.16daed770771dp-1),
+        UNIT(0x1.1e4e88411fd12p-1), UNIT(0x1.25abcf87c4979p-1), UNIT(0x1.2cf2304755a5ep-1),
+        UNIT(0x1.342119455beb7p-1), UNIT(0x1.3b37fb1bdc939p-1), UNIT(0x1.4236484487abep-1),
+        UNIT(0x1.491b7523c161dp-1), UNIT(0x1.4fe6f81384fd4p-1), UNIT(0x1.5698496e20bd8p-1),
+        UNIT(0x1.5d2ee398c9c2bp-1), UNIT(0x1.63aa430e07310p-1), UNIT(0x1.6a09e667f3bcdp-1),
+        UNIT(0x1.704d4e6a54d39p-1), UNIT(0x1.7673fe0c86982p-1), UNIT(0x1.7c7d7a833bec2p-1),
+        UNIT(0x1.82694b4a11c37p-1), UNIT(0x1.8836fa2cf5039p-1), UNIT(0x1.8de613515a328p-1),
+        UNIT(0x1.9376253f463d1p-1), UNIT(0x1.98e6c0ea27a14p-1), UNIT(0x1.9e3779b97f4a8p-1),
+        UNIT(0x1.a367e59158747p-1), UNIT(0x1.a8779cda8eea4p-1), UNIT(0x1.ad663a8ae2fdcp-1),
+        UNIT(0x1.b2335c2cda945p-1), UNIT(0x1.b6dea1e76eadep-1), UNIT(0x1.bb67ae8584cabp-1),
+        UNIT(0x1.bfce277d339c6p-1), UNIT(0x1.c411b4f6d2708p-1), UNIT(0x1.c83201d3d2c6dp-1),
+        UNIT(0x1.cc2ebbb5638cap-1), UNIT(0x1.d0079302dd767p-1), UNIT(0x1.d3bc3aeff7f95p-1),
+        UNIT(0x1.d74c6982c666fp-1), UNIT(0x1.dab7d7997cb58p-1), UNIT(0x1.ddfe40effb805p-1),
+        UNIT(0x1.e11f642522d1cp-1), UNIT(0x1.e41b02bfeb4cbp-1), UNIT(0x1.e6f0e134454ffp-1),
+        UNIT(0x1.e9a0c6e7bdb1fp-1), UNIT(0x1.ec2a7e35e7b80p-1), UNIT(0x1.ee8dd4748bf15p-1),
+        UNIT(0x1.f0ca99f79ba25p-1), UNIT(0x1.f2e0a214e870fp-1), UNIT(0x1.f4cfc327a0080p-1),
+        UNIT(0x1.f697d6938b6c2p-1), UNIT(0x1.f838b8c811c17p-1), UNIT(0x1.f9b24942fe45cp-1),
+        UNIT(0x1.fb046a930947ap-1), UNIT(0x1.fc2f025a23e8bp-1), UNIT(0x1.fd31f94f867c6p-1),
+        UNIT(0x1.fe0d3b41815a2p-1), UNIT(0x1.fec0b7170fff6p-1), UNIT(0x1.ff4c5ed12e61dp-1),
+        UNIT(0x1.ffb0278bf0567p-1), UNIT(0x1.ffec097f5af8ap-1), UNIT(0x1.0000000000000p+0),
+        UNIT(0x1.ffec097f5af8ap-1), UNIT(0x1.ffb0278bf0567p-1), UNIT(0x1.ff4c5ed12e61dp-1),
+        UNIT(0x1.fec0b7170fff6p-1), UNIT(0x1.fe0d3b41815a2p-1), UNIT(0x1.fd31f94f867c6p-1),
+        UNIT(0x1.fc2f025a23e8bp-1), UNIT(0x1.fb046a930947ap-1), UNIT(0x1.f9b24942fe45cp-1),
+        UNIT(0x1.f838b8c811c17p-1), UNIT(0x1.f697d6938b6c2p-1), UNIT(0x1.f4cfc327a0080p-1),
+        UNIT(0x1.f2e0a214e870fp-1), UNIT(0x1.f0ca99f79ba25p-1), UNIT(0x1.ee8dd4748bf15p-1),
+        UNIT(0x1.ec2a7e35e7b80p-1), UNIT(0x1.e9a0c6e7bdb1fp-1), UNIT(0x1.e6f0e134454ffp-1),
+        UNIT(0x1.e41b02bfeb4cbp-1), UNIT(0x1.e11f642522d1cp-1), UNIT(0x1.ddfe40effb805p-1),
+        UNIT(0x1.dab7d7997cb58p-1), UNIT(0x1.d74c6982c666fp-1), UNIT(0x1.d3bc3aeff7f95p-1),
+        UNIT(0x1.d0079302dd767p-1), UNIT(0x1.cc2ebbb5638cap-1), UNIT(0x1.c83201d3d2c6dp-1),
+        UNIT(0x1.c411b4f6d2708p-1), UNIT(0x1.bfce277d339c6p-1), UNIT(0x1.bb67ae8584cabp-1),
+        UNIT(0x1.b6dea1e76eadep-1), UNIT(0x1.b2335c2cda945p-1), UNIT(0x1.ad663a8ae2fdcp-1),
+        UNIT(0x1.a8779cda8eea4p-1), UNIT(0x1.a367e59158747p-1), UNIT(0x1.9e3779b97f4a8p-1),
+        UNIT(0x1.98e6c0ea27a14p-1), UNIT(0x1.9376253f463d1p-1), UNIT(0x1.8de613515a328p-1),
+        UNIT(0x1.8836fa2cf5039p-1), UNIT(0x1.82694b4a11c37p-1), UNIT(0x1.7c7d7a833bec2p-1),
+        UNIT(0x1.7673fe0c86982p-1), UNIT(0x1.704d4e6a54d39p-1), UNIT(0x1.6a09e667f3bcdp-1),
+        UNIT(0x1.63aa430e07310p-1), UNIT(0x1.5d2ee398c9c2bp-1), UNIT(0x1.5698496e20bd8p-1),
+        UNIT(0x1.4fe6f81384fd4p-1), UNIT(0x1.491b7523c161dp-1), UNIT(0x1.4236484487abep-1),
+        UNIT(0x1.3b37fb1bdc939p-1), UNIT(0x1.342119455beb7p-1), UNIT(0x1.2cf2304755a5ep-1),
+        UNIT(0x1.25abcf87c4979p-1), UNIT(0x1.1e4e88411fd12p-1), UNIT(0x1.16daed770771dp-1),
+        UNIT(0x1.0f5193eacdd2ap-1), UNIT(0x1.07b3120fddf13p-1), UNIT(0x1.0000000000001p-1),
+        UNIT(0x1.f071eedefa0eep-2), UNIT(0x1.e0bd27424507ap-2), UNIT(0x1.d0e2e2b44de01p-2),
+        UNIT(0x1.c0e45dabe05c9p-2), UNIT(0x1.b0c2d77379853p-2), UNIT(0x1.a07f921061ad1p-2),
+        UNIT(0x1.901bd2298ffaap-2), UNIT(0x1.7f98deee59680p-2), UNIT(0x1.6ef801fced33ep-2),
+        UNIT(0x1.5e3a8748a0bf7p-2), UNIT(0x1.4d61bd000cdddp-2), UNIT(0x1.3c6ef372fe950p-2),
+        UNIT(0x1.2b637cf83d5c8p-2), UNIT(0x1.1a40add328e29p-2), UNIT(0x1.0907dc1930690p-2),
+        UNIT(0x1.ef74bf2e4b91bp-3), UNIT(0x1.ccb3236cdc672p-3), UNIT(0x1.a9cd9ac4258fap-3),
+        UNIT(0x1.86c6ddd766253p-3), UNIT(0x1.63a1a7e0b738cp-3), UNIT(0x1.4060b67a85377p-3),
+        UNIT(0x1.1d06c968d9e1ap-3), UNIT(0x1.f32d44c4f62d4p-4), UNIT(0x1.ac2609b3c576bp-4),
+        UNIT(0x1.64fd6b8c28100p-4), UNIT(0x1.1db8f6d6a5123p-4), UNIT(0x1.acbc748efc921p-5),
+        UNIT(0x1.1de58c9f7dc37p-5), UNIT(0x1.1df0b2b89dd37p-6), UNIT(0x1.1a62633145c07p-54),
+        UNIT(-0x1.1df0b2b89dd14p-6), UNIT(-0x1.1de58c9f7dc25p-5), UNIT(-0x1.acbc748efc90fp-5),
+        UNIT(-0x1.1db8f6d6a512ap-4), UNIT(-0x1.64fd6b8c28107p-4), UNIT(-0x1.ac2609b3c5772p-4),
+        UNIT(-0x1.f32d44c4f62cbp-4), UNIT(-0x1.1d06c968d9e16p-3), UNIT(-0x1.4060b67a85373p-3),
+        UNIT(-0x1.63a1a7e0b7388p-3), UNIT(-0x1.86c6ddd76624fp-3), UNIT(-0x1.a9cd9ac4258f6p-3),
+        UNIT(-0x1.ccb3236cdc676p-3), UNIT(-0x1.ef74bf2e4b91fp-3), UNIT(-0x1.0907dc1930692p-2),
+        UNIT(-0x1.1a40add328e27p-2), UNIT(-0x1.2b637cf83d5c6p-2), UNIT(-0x1.3c6ef372fe94ep-2),
+        UNIT(-0x1.4d61bd000cddbp-2), UNIT(-0x1.5e3a8748a0bf5p-2), UNIT(-0x1.6ef801fced33cp-2),
+        UNIT(-0x1.7f98deee59682p-2), UNIT(-0x1.901bd2298ffabp-2), UNIT(-0x1.a07f921061ad2p-2),
+        UNIT(-0x1.b0c2d77379851p-2), UNIT(-0x1.c0e45dabe05cap-2), UNIT(-0x1.d0e2e2b44ddffp-2),
+        UNIT(-0x1.e0bd27424507bp-2), UNIT(-0x1.f071eedefa0ecp-2), UNIT(-0x1.ffffffffffffcp-2),
+        UNIT(-0x1.07b3120fddf14p-1), UNIT(-0x1.0f5193eacdd29p-1), UNIT(-0x1.16daed770771dp-1),
+        UNIT(-0x1.1e4e88411fd11p-1), UNIT(-0x1.25abcf87c4979p-1), UNIT(-0x1.2cf2304755a5dp-1),
+        UNIT(-0x1.342119455beb7p-1), UNIT(-0x1.3b37fb1bdc939p-1), UNIT(-0x1.4236484487abcp-1),
+        UNIT(-0x1.491b7523c161dp-1), UNIT(-0x1.4fe6f81384fd3p-1), UNIT(-0x1.5698496e20bd8p-1),
+        UNIT(-0x1.5d2ee398c9c2ap-1), UNIT(-0x1.63aa430e07311p-1), UNIT(-0x1.6a09e667f3bccp-1),
+        UNIT(-0x1.704d4e6a54d39p-1), UNIT(-0x1.7673fe0c86982p-1), UNIT(-0x1.7c7d7a833bec0p-1),
+        UNIT(-0x1.82694b4a11c37p-1), UNIT(-0x1.8836fa2cf5038p-1), UNIT(-0x1.8de613515a328p-1),
+        UNIT(-0x1.9376253f463d1p-1), UNIT(-0x1.98e6c0ea27a15p-1), UNIT(-0x1.9e3779b97f4a7p-1),
+        UNIT(-0x1.a367e59158748p-1), UNIT(-0x1.a8779cda8eea4p-1), UNIT(-0x1.ad663a8ae2fdbp-1),
+        UNIT(-0x1.b2335c2cda945p-1), UNIT(-0x1.b6dea1e76eaddp-1), UNIT(-0x1.bb67ae8584cabp-1),
+        UNIT(-0x1.bfce277d339c6p-1), UNIT(-0x1.c411b4f6d2708p-1), UNIT(-0x1.c83201d3d2c6cp-1),
+        UNIT(-0x1.cc2ebbb5638cap-1), UNIT(-0x1.d0079302dd767p-1), UNIT(-0x1.d3bc3aeff7f94p-1),
+        UNIT(-0x1.d74c6982c666fp-1), UNIT(-0x1.dab7d7997cb57p-1), UNIT(-0x1.ddfe40effb805p-1),
+        UNIT(-0x1.e11f642522d1bp-1), UNIT(-0x1.e41b02bfeb4cbp-1), UNIT(-0x1.e6f0e134454ffp-1),
+        UNIT(-0x1.e9a0c6e7bdb20p-1), UNIT(-0x1.ec2a7e35e7b80p-1), UNIT(-0x1.ee8dd4748bf14p-1),
+        UNIT(-0x1.f0ca99f79ba25p-1), UNIT(-0x1.f2e0a214e870ep-1), UNIT(-0x1.f4cfc327a0080p-1),
+        UNIT(-0x1.f697d6938b6c2p-1), UNIT(-0x1.f838b8c811c17p-1), UNIT(-0x1.f9b24942fe45bp-1),
+        UNIT(-0x1.fb046a930947ap-1), UNIT(-0x1.fc2f025a23e8bp-1), UNIT(-0x1.fd31f94f867c6p-1),
+        UNIT(-0x1.fe0d3b41815a2p-1), UNIT(-0x1.fec0b7170fff6p-1), UNIT(-0x1.ff4c5ed12e61dp-1),
+        UNIT(-0x1.ffb0278bf0567p-1), UNIT(-0x1.ffec097f5af8ap-1), UNIT(-0x1.0000000000000p+0),
+        UNIT(-0x1.ffec097f5af8ap-1), UNIT(-0x1.ffb0278bf0567p-1), UNIT(-0x1.ff4c5ed12e61dp-1),
+        UNIT(-0x1.fec0b7170fff6p-1), UNIT(-0x1.fe0d3b41815a2p-1), UNIT(-0x1.fd31f94f867c6p-1),
+        UNIT(-0x1.fc2f025a23e8cp-1), UNIT(-0x1.fb046a9309479p-1), UNIT(-0x1.f9b24942fe45cp-1),
+        UNIT(-0x1.f838b8c811c17p-1), UNIT(-0x1.f697d6938b6c2p-1), UNIT(-0x1.f4cfc327a007fp-1),
+        UNIT(-0x1.f2e0a214e870fp-1), UNIT(-0x1.f0ca99f79ba25p-1), UNIT(-0x1.ee8dd4748bf15p-1),
+        UNIT(-0x1.ec2a7e35e7b80p-1), UNIT(-0x1.e9a0c6e7bdb1fp-1), UNIT(-0x1.e6f0e13445500p-1),
+        UNIT(-0x1.e41b02bfeb4cap-1), UNIT(-0x1.e11f642522d1cp-1), UNIT(-0x1.ddfe40effb805p-1),
+        UNIT(-0x1.dab7d7997cb58p-1), UNIT(-0x1.d74c6982c666fp-1), UNIT(-0x1.d3bc3aeff7f95p-1),
+        UNIT(-0x1.d0079302dd768p-1), UNIT(-0x1.cc2ebbb5638c9p-1), UNIT(-0x1.c83201d3d2c6dp-1),
+        UNIT(-0x1.c411b4f6d2707p-1), UNIT(-0x1.bfce277d339c7p-1), UNIT(-0x1.bb67ae8584caap-1),
+        UNIT(-0x1.b6dea1e76eadep-1), UNIT(-0x1.b2335c2cda946p-1), UNIT(-0x1.ad663a8ae2fdcp-1),
+        UNIT(-0x1.a8779cda8eea6p-1), UNIT(-0x1.a367e59158747p-1), UNIT(-0x1.9e3779b97f4a9p-1),
+        UNIT(-0x1.98e6c0ea27a14p-1), UNIT(-0x1.9376253f463d2p-1), UNIT(-0x1.8de613515a327p-1),
+        UNIT(-0x1.8836fa2cf5039p-1), UNIT(-0x1.82694b4a11c38p-1), UNIT(-0x1.7c7d7a833bec2p-1),
+        UNIT(-0x1.7673fe0c86983p-1), UNIT(-0x1.704d4e6a54d38p-1), UNIT(-0x1.6a09e667f3bcep-1),
+        UNIT(-0x1.63aa430e07310p-1), UNIT(-0x1.5d2ee398c9c2cp-1), UNIT(-0x1.5698496e20bd7p-1),
+        UNIT(-0x1.4fe6f81384fd4p-1), UNIT(-0x1.491b7523c161ep-1), UNIT(-0x1.4236484487ac1p-1),
+        UNIT(-0x1.3b37fb1bdc937p-1), UNIT(-0x1.342119455beb6p-1), UNIT(-0x1.2cf2304755a5fp-1),
+        UNIT(-0x1.25abcf87c497bp-1), UNIT(-0x1.1e4e88411fd10p-1), UNIT(-0x1.16daed770771cp-1),
+        UNIT(-0x1.0f5193eacdd2bp-1), UNIT(-0x1.07b3120fddf16p-1), UNIT(-0x1.0000000000004p-1),
+        UNIT(-0x1.f071eedefa0e9p-2), UNIT(-0x1.e0bd274245078p-2), UNIT(-0x1.d0e2e2b44de03p-2),
+        UNIT(-0x1.c0e45dabe05cep-2), UNIT(-0x1.b0c2d7737984ep-2), UNIT(-0x1.a07f921061acfp-2),
+        UNIT(-0x1.901bd2298ffacp-2), UNIT(-0x1.7f98deee59686p-2), UNIT(-0x1.6ef801fced344p-2),
+        UNIT(-0x1.5e3a8748a0bf2p-2), UNIT(-0x1.4d61bd000cddbp-2), UNIT(-0x1.3c6ef372fe952p-2),
+        UNIT(-0x1.2b637cf83d5cep-2), UNIT(-0x1.1a40add328e24p-2), UNIT(-0x1.0907dc193068ep-2),
+        UNIT(-0x1.ef74bf2e4b91fp-3), UNIT(-0x1.ccb3236cdc67ep-3), UNIT(-0x1.a9cd9ac425906p-3),
+        UNIT(-0x1.86c6ddd766248p-3), UNIT(-0x1.63a1a7e0b7389p-3), UNIT(-0x1.4060b67a8537bp-3),
+        UNIT(-0x1.1d06c968d9e27p-3), UNIT(-0x1.f32d44c4f62bdp-4), UNIT(-0x1.ac2609b3c5764p-4),
+        UNIT(-0x1.64fd6b8c28108p-4), UNIT(-0x1.1db8f6d6a513cp-4), UNIT(-0x1.acbc748efc952p-5),
+        UNIT(-0x1.1de58c9f7dc09p-5), UNIT(-0x1.1df0b2b89dd1ap-6), UNIT(-0x1.a79394c9e8a0ap-53),
+        UNIT(0x1.1df0b2b89dcb0p-6), UNIT(0x1.1de58c9f7dc54p-5), UNIT(0x1.acbc748efc91ep-5),
+        UNIT(0x1.1db8f6d6a5122p-4), UNIT(0x1.64fd6b8c280eep-4), UNIT(0x1.ac2609b3c5749p-4),
+        UNIT(0x1.f32d44c4f62e2p-4), UNIT(0x1.1d06c968d9e1ap-3), UNIT(0x1.4060b67a8536ep-3),
+        UNIT(0x1.63a1a7e0b737cp-3), UNIT(0x1.86c6ddd76625ap-3), UNIT(0x1.a9cd9ac4258f9p-3),
+        UNIT(0x1.ccb3236cdc672p-3), UNIT(0x1.ef74bf2e4b913p-3), UNIT(0x1.0907dc1930688p-2),
+        UNIT(0x1.1a40add328e2dp-2), UNIT(0x1.2b637cf83d5c7p-2), UNIT(0x1.3c6ef372fe94cp-2),
+        UNIT(0x1.4d61bd000cdd5p-2), UNIT(0x1.5e3a8748a0bfap-2), UNIT(0x1.6ef801fced33ep-2),
+        UNIT(0x1.7f98deee59680p-2), UNIT(0x1.901bd2298ffa6p-2), UNIT(0x1.a07f921061ac9p-2),
+        UNIT(0x1.b0c2d77379856p-2), UNIT(0x1.c0e45dabe05c8p-2), UNIT(0x1.d0e2e2b44ddfep-2),
+        UNIT(0x1.e0bd274245072p-2), UNIT(0x1.f071eedefa0f1p-2), UNIT(0x1.0000000000001p-1),
+        UNIT(0x1.07b3120fddf13p-1), UNIT(0x1.0f5193eacdd28p-1), UNIT(0x1.16daed7707719p-1),
+        UNIT(0x1.1e4e88411fd14p-1), UNIT(0x1.25abcf87c4978p-1), UNIT(0x1.2cf2304755a5cp-1),
+        UNIT(0x1.342119455beb3p-1), UNIT(0x1.3b37fb1bdc93bp-1), UNIT(0x1.4236484487abep-1),
+        UNIT(0x1.491b7523c161cp-1), UNIT(0x1.4fe6f81384fd2p-1), UNIT(0x1.5698496e20bd4p-1),
+        UNIT(0x1.5d2ee398c9c2cp-1), UNIT(0x1.63aa430e07310p-1), UNIT(0x1.6a09e667f3bcbp-1),
+        UNIT(0x1.704d4e6a54d36p-1), UNIT(0x1.7673fe0c86984p-1), UNIT(0x1.7c7d7a833bec2p-1),
+        UNIT(0x1.82694b4a11c36p-1), UNIT(0x1.8836fa2cf5037p-1), UNIT(0x1.8de613515a325p-1),
+        UNIT(0x1.9376253f463d2p-1), UNIT(0x1.98e6c0ea27a14p-1), UNIT(0x1.9e3779b97f4a7p-1),
+        UNIT(0x1.a367e59158745p-1), UNIT(0x1.a8779cda8eea6p-1), UNIT(0x1.ad663a8ae2fdcp-1),
+        UNIT(0x1.b2335c2cda945p-1), UNIT(0x1.b6dea1e76eadcp-1), UNIT(0x1.bb67ae8584ca8p-1),
+        UNIT(0x1.bfce277d339c7p-1), UNIT(0x1.c411b4f6d2707p-1), UNIT(0x1.c83201d3d2c6cp-1),
+        UNIT(0x1.cc2ebbb5638c8p-1), UNIT(0x1.d0079302dd768p-1), UNIT(0x1.d3bc3aeff7f96p-1),
+        UNIT(0x1.d74c6982c666ep-1), UNIT(0x1.dab7d7997cb57p-1), UNIT(0x1.ddfe40effb803p-1),
+        UNIT(0x1.e11f642522d1cp-1), UNIT(0x1.e41b02bfeb4cbp-1), UNIT(0x1.e6f0e134454ffp-1),
+        UNIT(0x1.e9a0c6e7bdb1ep-1), UNIT(0x1.ec2a7e35e7b80p-1), UNIT(0x1.ee8dd4748bf15p-1),
+        UNIT(0x1.f0ca99f79ba25p-1), UNIT(0x1.f2e0a214e870ep-1), UNIT(0x1.f4cfc327a007fp-1),
+        UNIT(0x1.f697d6938b6c2p-1), UNIT(0x1.f838b8c811c17p-1), UNIT(0x1.f9b24942fe45bp-1),
+        UNIT(0x1.fb046a9309479p-1), UNIT(0x1.fc2f025a23e8cp-1), UNIT(0x1.fd31f94f867c6p-1),
+        UNIT(0x1.fe0d3b41815a2p-1), UNIT(0x1.fec0b7170fff6p-1), UNIT(0x1.ff4c5ed12e61dp-1),
+        UNIT(0x1.ffb0278bf0567p-1), UNIT(0x1.ffec097f5af8ap-1)
+};
+
+const position_t unit_sin[DIRECTIONS] = {
+        UNIT(0x1.1df0b2b89dd2cp-6), UNIT(0x1.1de58c9f7dc12p-5), UNIT(0x1.acbc748efc95bp-5),
+        UNIT(0x1.1db8f6d6a5140p-4), UNIT(0x1.64fd6b8c2810dp-4), UNIT(0x1.ac2609b3c5768p-4),
+        UNIT(0x1.f32d44c4f62c1p-4), UNIT(0x1.1d06c968d9e29p-3), UNIT(0x1.4060b67a8537ep-3),
+        UNIT(0x1.63a1a7e0b738bp-3), UNIT(0x1.86c6ddd76624ap-3), UNIT(0x1.a9cd9ac425909p-3),
+        UNIT(0x1.ccb3236cdc681p-3), UNIT(0x1.ef74bf2e4b922p-3), UNIT(0x1.0907dc193068fp-2),
+        UNIT(0x1.1a40add328e25p-2), UNIT(0x1.2b637cf83d5cfp-2), UNIT(0x1.3c6ef372fe953p-2),
+        UNIT(0x1.4d61bd000cddcp-2), UNIT(0x1.5e3a8748a0bf3p-2), UNIT(0x1.6ef801fced345p-2),
+        UNIT(0x1.7f98deee59687p-2), UNIT(0x1.901bd2298ffadp-2), UNIT(0x1.a07f921061ad0p-2),
+        UNIT(0x1.b0c2d7737984fp-2), UNIT(0x1.c0e45dabe05cfp-2), UNIT(0x1.d0e2e2b44de04p-2),
+        UNIT(0x1.e0bd274245079p-2), UNIT(0x1.f071eedefa0eap-2), UNIT(0x1.0000000000004p-1),
+        UNIT(0x1.07b3120fddf16p-1), UNIT(0x1.0f5193eacdd2bp-1), UNIT(0x1.16daed770771cp-1),
+        UNIT(0x1.1e4e88411fd10p-1), UNIT(0x1.25abcf87c497cp-1), UNIT(0x1.2cf2304755a60p-1),
+        UNIT(0x1.342119455beb6p-1), UNIT(0x1.3b37fb1bdc938p-1), UNIT(0x1.4236484487ac1p-1),
+        UNIT(0x1.491b7523c161fp-1), UNIT(0x1.4fe6f81384fd5p-1), UNIT(0x1.5698496e20bd7p-1),
+        UNIT(0x1.5d2ee398c9c29p-1), UNIT(0x1.63aa430e07313p-1), UNIT(0x1.6a09e667f3bcep-1),
+        UNIT(0x1.704d4e6a54d39p-1), UNIT(0x1.7673fe0c86981p-1), UNIT(0x1.7c7d7a833bec5p-1),
+        UNIT(0x1.82694b4a11c39p-1), UNIT(0x1.8836fa2cf503ap-1), UNIT(0x1.8de613515a327p-1),
+        UNIT(0x1.9376253f463d0p-1), UNIT(0x1.98e6c0ea27a16p-1), UNIT(0x1.9e3779b97f4a9p-1),
+        UNIT(0x1.a367e59158747p-1), UNIT(0x1.a8779cda8eea4p-1), UNIT(0x1.ad663a8ae2fdep-1),
+        UNIT(0x1.b2335c2cda947p-1), UNIT(0x1.b6dea1e76eadep-1), UNIT(0x1.bb67ae8584caap-1),
+        UNIT(0x1.bfce277d339c5p-1), UNIT(0x1.c411b4f6d2709p-1), UNIT(0x1.c83201d3d2c6ep-1),
+        UNIT(0x1.cc2ebbb5638cap-1), UNIT(0x1.d0079302dd767p-1), UNIT(0x1.d3bc3aeff7f97p-1),
+        UNIT(0x1.d74c6982c6670p-1), UNIT(0x1.dab7d7997cb58p-1), UNIT(0x1.ddfe40effb805p-1),
+        UNIT(0x1.e11f642522d1bp-1), UNIT(0x1.e41b02bfeb4ccp-1), UNIT(0x1.e6f0e13445500p-1),
+        UNIT(0x1.e9a0c6e7bdb1fp-1), UNIT(0x1.ec2a7e35e7b7fp-1), UNIT(0x1.ee8dd4748bf16p-1),
+        UNIT(0x1.f0ca99f79ba26p-1), UNIT(0x1.f2e0a214e870fp-1), UNIT(0x1.f4cfc327a007fp-1),
+        UNIT(0x1.f697d6938b6c1p-1), UNIT(0x1.f838b8c811c18p-1), UNIT(0x1.f9b24942fe45cp-1),
+        UNIT(0x1.fb046a930947ap-1), UNIT(0x1.fc2f025a23e8bp-1), UNIT(0x1.fd31f94f867c7p-1),
+        UNIT(0x1.fe0d3b41815a2p-1), UNIT(0x1.fec0b7170fff7p-1), UNIT(0x1.ff4c5ed12e61dp-1),
+        UNIT(0x1.ffb0278bf0567p-1), UNIT(0x1.ffec097f5af8ap-1), UNIT(0x1.0000000000000p+0),
+        UNIT(0x1.ffec097f5af8ap-1), UNIT(0x1.ffb0278bf0567p-1), UNIT(0x1.ff4c5ed12e61dp-1),
+        UNIT(0x1.fec0b7170fff6p-1), UNIT(0x1.fe0d3b41815a2p-1), UNIT(0x1.fd31f94f867c7p-1),
+        UNIT(0x1.fc2f025a23e8cp-1), UNIT(0x1.fb046a9309479p-1), UNIT(0x1.f9b24942fe45bp-1),
+        UNIT(0x1.f838b8c811c17p-1), UNIT(0x1.f697d6938b6c2p-1), UNIT(0x1.f4cfc327a007fp-1),
+        UNIT(0x1.f2e0a214e870ep-1), UNIT(0x1.f0ca99f79ba25p-1), UNIT(0x1.ee8dd4748bf15p-1),
+        UNIT(0x1.ec2a7e35e7b81p-1), UNIT(0x1.e9a0c6e7bdb1ep-1), UNIT(0x1.e6f0e134454ffp-1),
+        UNIT(0x1.e41b02bfeb4cbp-1), UNIT(0x1.e11f642522d1cp-1), UNIT(0x1.ddfe40effb804p-1),
+        UNIT(0x1.dab7d7997cb57p-1), UNIT(0x1.d74c6982c666ep-1), UNIT(0x1.d3bc3aeff7f96p-1),
+        UNIT(0x1.d0079302dd768p-1), UNIT(0x1.cc2ebbb5638c8p-1), UNIT(0x1.c83201d3d2c6cp-1),
+        UNIT(0x1.c411b4f6d2708p-1), UNIT(0x1.bfce277d339c8p-1), UNIT(0x1.bb67ae8584ca8p-1),
+        UNIT(0x1.b6dea1e76eadcp-1), UNIT(0x1.b2335c2cda945p-1), UNIT(0x1.ad663a8ae2fdcp-1),
+        UNIT(0x1.a8779cda8eea6p-1), UNIT(0x1.a367e59158745p-1), UNIT(0x1.9e3779b97f4a7p-1),
+        UNIT(0x1.98e6c0ea27a14p-1), UNIT(0x1.9376253f463d3p-1), UNIT(0x1.8de613515a325p-1),
+        UNIT(0x1.8836fa2cf5038p-1), UNIT(0x1.82694b4a11c37p-1), UNIT(0x1.7c7d7a833bec3p-1),
+        UNIT(0x1.7673fe0c86982p-1), UNIT(0x1.704d4e6a54d39p-1), UNIT(0x1.6a09e667f3bccp-1),
+        UNIT(0x1.63aa430e07311p-1), UNIT(0x1.5d2ee398c9c2ap-1), UNIT(0x1.5698496e20bd8p-1),
+        UNIT(0x1.4fe6f81384fd2p-1), UNIT(0x1.491b7523c161cp-1), UNIT(0x1.4236484487abfp-1),
+        UNIT(0x1.3b37fb1bdc938p-1), UNIT(0x1.342119455beb7p-1), UNIT(0x1.2cf2304755a5dp-1),
+        UNIT(0x1.25abcf87c4979p-1), UNIT(0x1.1e4e88411fd11p-1), UNIT(0x1.16daed770771dp-1),
+        UNIT(0x1.0f5193eacdd29p-1), UNIT(0x1.07b3120fddf13p-1), UNIT(0x1.0000000000001p-1),
+        UNIT(0x1.f071eedefa0ebp-2), UNIT(0x1.e0bd27424507ap-2), UNIT(0x1.d0e2e2b44ddffp-2),
+        UNIT(0x1.c0e45dabe05c9p-2), UNIT(0x1.b0c2d77379850p-2), UNIT(0x1.a07f921061ad1p-2),
+        UNIT(0x1.901bd2298ffa7p-2), UNIT(0x1.7f98deee59681p-2), UNIT(0x1.6ef801fced33fp-2),
+        UNIT(0x1.5e3a8748a0bf4p-2), UNIT(0x1.4d61bd000cdddp-2), UNIT(0x1.3c6ef372fe94dp-2),
+        UNIT(0x1.2b637cf83d5c8p-2), UNIT(0x1.1a40add328e26p-2), UNIT(0x1.0907dc1930691p-2),
+        UNIT(0x1.ef74bf2e4b915p-3), UNIT(0x1.ccb3236cdc674p-3), UNIT(0x1.a9cd9ac4258fcp-3),
+        UNIT(0x1.86c6ddd76624cp-3), UNIT(0x1.63a1a7e0b738ep-3), UNIT(0x1.4060b67a85370p-3),
+        UNIT(0x1.1d06c968d9e1cp-3), UNIT(0x1.f32d44c4f62c7p-4), UNIT(0x1.ac2609b3c576ep-4),
+        UNIT(0x1.64fd6b8c280f2p-4), UNIT(0x1.1db8f6d6a5126p-4), UNIT(0x1.acbc748efc8e7p-5),
+        UNIT(0x1.1de58c9f7dc1dp-5), UNIT(0x1.1df0b2b89dd42p-6), UNIT(-0x1.1a62633145c07p-53),
+        UNIT(-0x1.1df0b2b89dd09p-6), UNIT(-0x1.1de58c9f7dc40p-5), UNIT(-0x1.acbc748efc90ap-5),
+        UNIT(-0x1.1db8f6d6a5138p-4), UNIT(-0x1.64fd6b8c28104p-4), UNIT(-0x1.ac2609b3c577fp-4),
+        UNIT(-0x1.f32d44c4f62d8p-4), UNIT(-0x1.1d06c968d9e15p-3), UNIT(-0x1.4060b67a85379p-3),
+        UNIT(-0x1.63a1a7e0b7387p-3), UNIT(-0x1.86c6ddd766255p-3), UNIT(-0x1.a9cd9ac4258f5p-3),
+        UNIT(-0x1.ccb3236cdc67cp-3), UNIT(-0x1.ef74bf2e4b91dp-3), UNIT(-0x1.0907dc1930695p-2),
+        UNIT(-0x1.1a40add328e2ap-2), UNIT(-0x1.2b637cf83d5c5p-2), UNIT(-0x1.3c6ef372fe951p-2),
+        UNIT(-0x1.4d61bd000cddap-2), UNIT(-0x1.5e3a8748a0bf8p-2), UNIT(-0x1.6ef801fced33bp-2),
+        UNIT(-0x1.7f98deee59685p-2), UNIT(-0x1.901bd2298ffabp-2), UNIT(-0x1.a07f921061ad5p-2),
+        UNIT(-0x1.b0c2d77379854p-2), UNIT(-0x1.c0e45dabe05c6p-2), UNIT(-0x1.d0e2e2b44de02p-2),
+        UNIT(-0x1.e0bd274245077p-2), UNIT(-0x1.f071eedefa0efp-2), UNIT(-0x1.fffffffffffffp-2),
+        UNIT(-0x1.07b3120fddf15p-1), UNIT(-0x1.0f5193eacdd2ap-1), UNIT(-0x1.16daed770771fp-1),
+        UNIT(-0x1.1e4e88411fd13p-1), UNIT(-0x1.25abcf87c4977p-1), UNIT(-0x1.2cf2304755a5fp-1),
+        UNIT(-0x1.342119455beb5p-1), UNIT(-0x1.3b37fb1bdc93ap-1), UNIT(-0x1.4236484487abdp-1),
+        UNIT(-0x1.491b7523c161ep-1), UNIT(-0x1.4fe6f81384fd4p-1), UNIT(-0x1.5698496e20bd9p-1),
+        UNIT(-0x1.5d2ee398c9c2cp-1), UNIT(-0x1.63aa430e0730fp-1), UNIT(-0x1.6a09e667f3bcdp-1),
+        UNIT(-0x1.704d4e6a54d38p-1), UNIT(-0x1.7673fe0c86983p-1), UNIT(-0x1.7c7d7a833bec2p-1),
+        UNIT(-0x1.82694b4a11c38p-1), UNIT(-0x1.8836fa2cf5039p-1), UNIT(-0x1.8de613515a329p-1),
+        UNIT(-0x1.9376253f463d2p-1), UNIT(-0x1.98e6c0ea27a13p-1), UNIT(-0x1.9e3779b97f4a8p-1),
+        UNIT(-0x1.a367e59158746p-1), UNIT(-0x1.a8779cda8eea5p-1), UNIT(-0x1.ad663a8ae2fdbp-1),
+        UNIT(-0x1.b2335c2cda946p-1), UNIT(-0x1.b6dea1e76eadep-1), UNIT(-0x1.bb67ae8584cabp-1),
+        UNIT(-0x1.bfce277d339c7p-1), UNIT(-0x1.c411b4f6d2707p-1), UNIT(-0x1.c83201d3d2c6dp-1),
+        UNIT(-0x1.cc2ebbb5638c9p-1), UNIT(-0x1.d0079302dd768p-1), UNIT(-0x1.d3bc3aeff7f95p-1),
+        UNIT(-0x1.d74c6982c666ep-1), UNIT(-0x1.dab7d7997cb58p-1), UNIT(-0x1.ddfe40effb805p-1),
+        UNIT(-0x1.e11f642522d1cp-1), UNIT(-0x1.e41b02bfeb4cbp-1), UNIT(-0x1.e6f0e13445500p-1),
+        UNIT(-0x1.e9a0c6e7bdb20p-1), UNIT(-0x1.ec2a7e35e7b80p-1), UNIT(-0x1.ee8dd4748bf15p-1),
+        UNIT(-0x1.f0ca99f79ba25p-1), UNIT(-0x1.f2e0a214e870fp-1), UNIT(-0x1.f4cfc327a0080p-1),
+        UNIT(-0x1.f697d6938b6c2p-1), UNIT(-0x1.f838b8c811c17p-1), UNIT(-0x1.f9b24942fe45cp-1),
+        UNIT(-0x1.fb046a930947ap-1), UNIT(-0x1.fc2f025a23e8cp-1), UNIT(-0x1.fd31f94f867c6p-1),
+        UNIT(-0x1.fe0d3b41815a2p-1), UNIT(-0x1.fec0b7170fff6p-1), UNIT(-0x1.ff4c5ed12e61dp-1),
+        UNIT(-0x1.ffb0278bf0567p-1), UNIT(-0x1.ffec097f5af8ap-1), UNIT(-0x1.0000000000000p+0),
+        UNIT(-0x1.ffec097f5af8ap-1), UNIT(-0x1.ffb0278bf0567p-1), UNIT(-0x1.ff4c5ed12e61dp-1),
+        UNIT(-0x1.fec0b7170fff6p-1), UNIT(-0x1.fe0d3b41815a2p-1), UNIT(-0x1.fd31f94f867c6p-1),
+        UNIT(-0x1.fc2f025a23e8bp-1), UNIT(-0x1.fb046a930947ap-1), UNIT(-0x1.f9b24942fe45cp-1),
+        UNIT(-0x1.f838b8c811c17p-1), UNIT(-0x1.f697d6938b6c2p-1), UNIT(-0x1.f4cfc327a007fp-1),
+        UNIT(-0x1.f2e0a214e870fp-1), UNIT(-0x1.f0ca99f79ba25p-1), UNIT(-0x1.ee8dd4748bf15p-1),
+        UNIT(-0x1.ec2a7e35e7b80p-1), UNIT(-0x1.e9a0c6e7bdb1fp-1), UNIT(-0x1.e6f0e134454ffp-1),
+        UNIT(-0x1.e41b02bfeb4cap-1), UNIT(-0x1.e11f642522d1bp-1), UNIT(-0x1.ddfe40effb805p-1),
+        UNIT(-0x1.dab7d7997cb58p-1), UNIT(-0x1.d74c6982c666fp-1), UNIT(-0x1.d3bc3aeff7f95p-1),
+        UNIT(-0x1.d0079302dd767p-1), UNIT(-0x1.cc2ebbb5638cap-1), UNIT(-0x1.c83201d3d2c6cp-1),
+        UNIT(-0x1.c411b4f6d2707p-1), UNIT(-0x1.bfce277d339c6p-1), UNIT(-0x1.bb67ae8584caap-1),
+        UNIT(-0x1.b6dea1e76eadep-1), UNIT(-0x1.b2335c2cda945p-1), UNIT(-0x1.ad663a8ae2fdcp-1),
+        UNIT(-0x1.a8779cda8eea5p-1), UNIT(-0x1.a367e59158747p-1), UNIT(-0x1.9e3779b97f4a8p-1),
+        UNIT(-0x1.98e6c0ea27a14p-1), UNIT(-0x1.9376253f463d2p-1), UNIT(-0x1.8de613515a328p-1),
+        UNIT(-0x1.8836fa2cf5039p-1), UNIT(-0x1.82694b4a11c37p-1), UNIT(-0x1.7c7d7a833bec2p-1),
+        UNIT(-0x1.7673fe0c86982p-1), UNIT(-0x1.704d4e6a54d38p-1), UNIT(-0x1.6a09e667f3bccp-1),
+        UNIT(-0x1.63aa430e07310p-1), UNIT(-0x1.5d2ee398c9c2bp-1), UNIT(-0x1.5698496e20bd8p-1),
+        UNIT(-0x1.4fe6f81384fd4p-1), UNIT(-0x1.491b7523c161cp-1), UNIT(-0x1.4236484487abdp-1),
+        UNIT(-0x1.3b37fb1bdc939p-1), UNIT(-0x1.342119455beb6p-1), UNIT(-0x1.2cf2304755a5ep-1),
+        UNIT(-0x1.25abcf87c4978p-1), UNIT(-0x1.1e4e88411fd13p-1), UNIT(-0x1.16daed770771dp-1),
+        UNIT(-0x1.0f5193eacdd2ap-1), UNIT(-0x1.07b3120fddf13p-1), UNIT(-0x1.fffffffffffffp-2),
+        UNIT(-0x1.f071eedefa0edp-2), UNIT(-0x1.e0bd274245079p-2), UNIT(-0x1.d0e2e2b44de00p-2),
+        UNIT(-0x1.c0e45dabe05c8p-2), UNIT(-0x1.b0c2d77379853p-2), UNIT(-0x1.a07f921061ad1p-2),
+        UNIT(-0x1.901bd2298ffabp-2), UNIT(-0x1.7f98deee59681p-2), UNIT(-0x1.6ef801fced33cp-2),
+        UNIT(-0x1.5e3a8748a0bf5p-2), UNIT(-0x1.4d61bd000cddcp-2), UNIT(-0x1.3c6ef372fe94fp-2),
+        UNIT(-0x1.2b637cf83d5c8p-2), UNIT(-0x1.1a40add328e29p-2), UNIT(-0x1.0907dc1930690p-2),
+        UNIT(-0x1.ef74bf2e4b91dp-3), UNIT(-0x1.ccb3236cdc675p-3), UNIT(-0x1.a9cd9ac4258f6p-3),
+        UNIT(-0x1.86c6ddd76624fp-3), UNIT(-0x1.63a1a7e0b7389p-3), UNIT(-0x1.4060b67a85375p-3),
+        UNIT(-0x1.1d06c968d9e19p-3), UNIT(-0x1.f32d44c4f62d3p-4), UNIT(-0x1.ac2609b3c576cp-4),
+        UNIT(-0x1.64fd6b8c28102p-4), UNIT(-0x1.1db8f6d6a5128p-4), UNIT(-0x1.acbc748efc90ep-5),
+        UNIT(-0x1.1de58c9f7dc27p-5), UNIT(-0x1.1df0b2b89dd1ep-6), UNIT(0x0.0p+0),
+        UNIT(0x1.1df0b2b89dd1ep-6), UNIT(0x1.1de58c9f7dc27p-5), UNIT(0x1.acbc748efc90ep-5),
+        UNIT(0x1.1db8f6d6a5128p-4), UNIT(0x1.64fd6b8c28102p-4), UNIT(0x1.ac2609b3c576cp-4),
+        UNIT(0x1.f32d44c4f62d3p-4), UNIT(0x1.1d06c968d9e19p-3), UNIT(0x1.4060b67a85375p-3),
+        UNIT(0x1.63a1a7e0b7389p-3), UNIT(0x1.86c6ddd76624fp-3), UNIT(0x1.a9cd9ac4258f6p-3),
+        UNIT(0x1.ccb3236cdc675p-3), UNIT(0x1.ef74bf2e4b91dp-3), UNIT(0x1.0907dc1930690p-2),
+        UNIT(0x1.1a40add328e29p-2), UNIT(0x1.2b637cf83d5c8p-2), UNIT(0x1.3c6ef372fe94fp-2),
+        UNIT(0x1.4d61bd000cddcp-2), UNIT(0x1.5e3a8748a0bf5p-2), UNIT(0x1.6ef801fced33cp-2),
+        UNIT(0x1.7f98deee59681p-2), UNIT(0x1.901bd2298ffabp-2), UNIT(0x1.a07f921061ad1p-2),
+        UNIT(0x1.b0c2d77379853p-2), UNIT(0x1.c0e45dabe05c8p-2), UNIT(0x1.d0e2e2b44de00p-2),
+        UNIT(0x1.e0bd274245079p-2), UNIT(0x1.f071eedefa0edp-2), UNIT(0x1.fffffffffffffp-2),
+        UNIT(0x1.07b3120fddf13p-1), UNIT(0x1.0f5193eacdd2ap-1), UNIT(0x1.16daed770771dp-1),
+        UNIT(0x1.1e4e88411fd13p-1), UNIT(0x1.25abcf87c4978p-1), UNIT(0x1.2cf2304755a5ep-1),
+        UNIT(0x1.342119455beb6p-1), UNIT(0x1.3b37fb1bdc939p-1), UNIT(0x1.4236484487abdp-1),
+        UNIT(0x1.491b7523c161cp-1), UNIT(0x1.4fe6f81384fd4p-1), UNIT(0x1.5698496e20bd8p-1),
+        UNIT(0x1.5d2ee398c9c2bp-1), UNIT(0x1.63aa430e07310p-1), UNIT(0x1.6a09e667f3bccp-1),
+        UNIT(0x1.704d4e6a54d38p-1), UNIT(0x1.7673fe0c86982p-1), UNIT(0x1.7c7d7a833bec2p-1),
+        UNIT(0x1.82694b4a11c37p-1), UNIT(0x1.8836fa2cf5039p-1), UNIT(0x1.8de613515a328p-1),
+        UNIT(0x1.9376253f463d2p-1), UNIT(0x1.98e6c0ea27a14p-1), UNIT(0x1.9e3779b97f4a8p-1),
+        UNIT(0x1.a367e59158747p-1), UNIT(0x1.a8779cda8eea5p-1), UNIT(0x1.ad663a8ae2fdcp-1),
+        UNIT(0x1.b2335c2cda945p-1), UNIT(0x1.b6dea1e76eadep-1), UNIT(0x1.bb67ae8584caap-1),
+        UNIT(0x1.bfce277d339c6p-1), UNIT(0x1.c411b4f6d2707p-1), UNIT(0x1.c83201d3d2c6cp-1),
+        UNIT(0x1.cc2ebbb5638cap-1), UNIT(0x1.d0079302dd767p-1), UNIT(0x1.d3bc3aeff7f95p-1),
+        UNIT(0x1.d74c6982c666fp-1), UNIT(0x1.dab7d7997cb58p-1), UNIT(0x1.ddfe40effb805p-1),
+        UNIT(0x1.e11f642522d1bp-1), UNIT(0x1.e41b02bfeb4cap-1), UNIT(0x1.e6f0e134454ffp-1),
+        UNIT(0x1.e9a0c6e7bdb1fp-1), UNIT(0x1.ec2a7e35e7b80p-1), UNIT(0x1.ee8dd4748bf15p-1),
+        UNIT(0x1.f0ca99f79ba25p-1), UNIT(0x1.f2e0a214e870fp-1), UNIT(0x1.f4cfc327a007fp-1),
+        UNIT(0x1.f697d6938b6c2p-1), UNIT(0x1.f838b8c811c17p-1), UNIT(0x1.f9b24942fe45cp-1),
+        UNIT(0x1.fb046a930947ap-1), UNIT(0x1.fc2f025a23e8bp-1), UNIT(0x1.fd31f94f867c6p-1),
+        UNIT(0x1.fe0d3b41815a2p-1), UNIT(0x1.fec0b7170fff6p-1), UNIT(0x1.ff4c5ed12e61dp-1),
+        UNIT(0x1.ffb0278bf0567p-1), UNIT(0x1.ffec097f5af8ap-1), UNIT(0x1.0000000000000p+0),
+        UNIT(0x1.ffec097f5af8ap-1), UNIT(0x1.ffb0278bf0567p-1), UNIT(0x1.ff4c5ed12e61dp-1),
+        UNIT(0x1.fec0b7170fff6p-1), UNIT(0x1.fe0d3b41815a2p-1), UNIT(0x1.fd31f94f867c6p-1),
+        UNIT(0x1.fc2f025a23e8cp-1), UNIT(0x1.fb046a930947ap-1), UNIT(0x1.f9b24942fe45cp-1),
+        UNIT(0x1.f838b8c811c17p-1), UNIT(0x1.f697d6938b6c2p-1), UNIT(0x1.f4cfc327a0080p-1),
+        UNIT(0x1.f2e0a214e870fp-1), UNIT(0x1.f0ca99f79ba25p-1), UNIT(0x1.ee8dd4748bf15p-1),
+        UNIT(0x1.ec2a7e35e7b80p-1), UNIT(0x1.e9a0c6e7bdb20p-1), UNIT(0x1.e6f0e13445500p-1),
+        UNIT(0x1.e41b02bfeb4cbp-1), UNIT(0x1.e11f642522d1cp-1), UNIT(0x1.ddfe40effb805p-1),
+        UNIT(0x1.dab7d7997cb58p-1), UNIT(0x1.d74c6982c666ep-1), UNIT(0x1.d3bc3aeff7f95p-1),
+        UNIT(0x1.d0079302dd768p-1), UNIT(0x1.cc2ebbb5638c9p-1), UNIT(0x1.c83201d3d2c6dp-1),
+        UNIT(0x1.c411b4f6d2707p-1), UNIT(0x1.bfce277d339c7p-1), UNIT(0x1.bb67ae8584cabp-1),
+        UNIT(0x1.b6dea1e76eadep-1), UNIT(0x1.b2335c2cda946p-1), UNIT(0x1.ad663a8ae2fdbp-1),
+        UNIT(0x1.a8779cda8eea5p-1), UNIT(0x1.a367e59158746p-1), UNIT(0x1.9e3779b97f4a8p-1),
+        UNIT(0x1.98e6c0ea27a13p-1), UNIT(0x1.9376253f463d2p-1), UNIT(0x1.8de613515a329p-1),
+        UNIT(0x1.8836fa2cf5039p-1), UNIT(0x1.82694b4a11c38p-1), UNIT(0x1.7c7d7a833bec2p-1),
+        UNIT(0x1.7673fe0c86983p-1), UNIT(0x1.704d4e6a54d38p-1), UNIT(0x1.6a09e667f3bcdp-1),
+        UNIT(0x1.63aa430e0730fp-1), UNIT(0x1.5d2ee398c9c2cp-1), UNIT(0x1.5698496e20bd9p-1),
+        UNIT(0x1.4fe6f81384fd4p-1), UNIT(0x1.491b7523c161ep-1), UNIT(0x1.4236484487abdp-1),
+        UNIT(0x1.3b37fb1bdc93ap-1), UNIT(0x1.342119455beb5p-1), UNIT(0x1.2cf2304755a5fp-1),
+        UNIT(0x1.25abcf87c4977p-1), UNIT(0x1.1e4e88411fd13p-1), UNIT(0x1.16daed770771fp-1),
+        UNIT(0x1.0f5193eacdd2ap-1), UNIT(0x1.07b3120fddf15p-1), UNIT(0x1.fffffffffffffp-2),
+        UNIT(0x1.f071eedefa0efp-2), UNIT(0x1.e0bd274245077p-2), UNIT(0x1.d0e2e2b44de02p-2),
+        UNIT(0x1.c0e45dabe05c6p-2), UNIT(0x1.b0c2d77379854p-2), UNIT(0x1.a07f921061ad5p-2),
+        UNIT(0x1.901bd2298ffabp-2), UNIT(0x1.7f98deee59685p-2), UNIT(0x1.6ef801fced33bp-2),
+        UNIT(0x1.5e3a8748a0bf8p-2), UNIT(0x1.4d61bd000cddap-2), UNIT(0x1.3c6ef372fe951p-2),
+        UNIT(0x1.2b637cf83d5c5p-2), UNIT(0x1.1a40add328e2ap-2), UNIT(0x1.0907dc1930695p-2),
+        UNIT(0x1.ef74bf2e4b91dp-3), UNIT(0x1.ccb3236cdc67cp-3), UNIT(0x1.a9cd9ac4258f5p-3),
+        UNIT(0x1.86c6ddd766255p-3), UNIT(0x1.63a1a7e0b7387p-3), UNIT(0x1.4060b67a85379p-3),
+        UNIT(0x1.1d06c968d9e15p-3), UNIT(0x1.f32d44c4f62d8p-4), UNIT(0x1.ac2609b3c577fp-4),
+        UNIT(0x1.64fd6b8c28104p-4), UNIT(0x1.1db8f6d6a5138p-4), UNIT(0x1.acbc748efc90ap-5),
+        UNIT(0x1.1de58c9f7dc40p-5), UNIT(0x1.1df0b2b89dd09p-6), UNIT(0x1.1a62633145c07p-53),
+        UNIT(-0x1.1df0b2b89dd42p-6), UNIT(-0x1.1de58c9f7dc1dp-5), UNIT(-0x1.acbc748efc8e7p-5),
+        UNIT(-0x1.1db8f6d6a5126p-4), UNIT(-0x1.64fd6b8c280f2p-4), UNIT(-0x1.ac2609b3c576ep-4),
+        UNIT(-0x1.f32d44c4f62c7p-4), UNIT(-0x1.1d06c968d9e1cp-3), UNIT(-0x1.4060b67a85370p-3),
+        UNIT(-0x1.63a1a7e0b738ep-3), UNIT(-0x1.86c6ddd76624cp-3), UNIT(-0x1.a9cd9ac4258fcp-3),
+        UNIT(-0x1.ccb3236cdc674p-3), UNIT(-0x1.ef74bf2e4b915p-3), UNIT(-0x1.0907dc1930691p-2),
+        UNIT(-0x1.1a40add328e26p-2), UNIT(-0x1.2b637cf83d5c8p-2), UNIT(-0x1.3c6ef372fe94dp-2),
+        UNIT(-0x1.4d61bd000cdddp-2), UNIT(-0x1.5e3a8748a0bf4p-2), UNIT(-0x1.6ef801fced33fp-2),
+        UNIT(-0x1.7f98deee59681p-2), UNIT(-0x1.901bd2298ffa7p-2), UNIT(-0x1.a07f921061ad1p-2),
+        UNIT(-0x1.b0c2d77379850p-2), UNIT(-0x1.c0e45dabe05c9p-2), UNIT(-0x1.d0e2e2b44ddffp-2),
+        UNIT(-0x1.e0bd27424507ap-2), UNIT(-0x1.f071eedefa0ebp-2), UNIT(-0x1.0000000000001p-1),
+        UNIT(-0x1.07b3120fddf13p-1), UNIT(-0x1.0f5193eacdd29p-1), UNIT(-0x1.16daed770771dp-1),
+        UNIT(-0x1.1e4e88411fd11p-1), UNIT(-0x1.25abcf87c4979p-1), UNIT(-0x1.2cf2304755a5dp-1),
+        UNIT(-0x1.342119455beb7p-1), UNIT(-0x1.3b37fb1bdc938p-1), UNIT(-0x1.4236484487abfp-1),
+        UNIT(-0x1.491b7523c161cp-1), UNIT(-0x1.4fe6f81384fd2p-1), UNIT(-0x1.5698496e20bd8p-1),
+        UNIT(-0x1.5d2ee398c9c2ap-1), UNIT(-0x1.63aa430e07311p-1), UNIT(-0x1.6a09e667f3bccp-1),
+        UNIT(-0x1.704d4e6a54d39p-1), UNIT(-0x1.7673fe0c86982p-1), UNIT(-0x1.7c7d7a833bec3p-1),
+        UNIT(-0x1.82694b4a11c37p-1), UNIT(-0x1.8836fa2cf5038p-1), UNIT(-0x1.8de613515a325p-1),
+        UNIT(-0x1.9376253f463d3p-1), UNIT(-0x1.98e6c0ea27a14p-1), UNIT(-0x1.9e3779b97f4a7p-1),
+        UNIT(-0x1.a367e59158745p-1), UNIT(-0x1.a8779cda8eea6p-1), UNIT(-0x1.ad663a8ae2fdcp-1),
+        UNIT(-0x1.b2335c2cda945p-1), UNIT(-0x1.b6dea1e76eadcp-1), UNIT(-0x1.bb67ae8584ca8p-1),
+        UNIT(-0x1.bfce277d339c8p-1), UNIT(-0x1.c411b4f6d2708p-1), UNIT(-0x1.c83201d3d2c6cp-1),
+        UNIT(-0x1.cc2ebbb5638c8p-1), UNIT(-0x1.d0079302dd768p-1), UNIT(-0x1.d3bc3aeff7f96p-1),
+        UNIT(-0x1.d74c6982c666ep-1), UNIT(-0x1.dab7d7997cb57p-1), UNIT(-0x1.ddfe40effb804p-1),
+        UNIT(-0x1.e11f642522d1cp-1), UNIT(-0x1.e41b02bfeb4cbp-1), UNIT(-0x1.e6f0e134454ffp-1),
+        UNIT(-0x1.e9a0c6e7bdb1ep-1), UNIT(-0x1.ec2a7e35e7b81p-1), UNIT(-0x1.ee8dd4748bf15p-1),
+        UNIT(-0x1.f0ca99f79ba25p-1), UNIT(-0x1.f2e0a214e870ep-1), UNIT(-0x1.f4cfc327a007fp-1),
+        UNIT(-0x1.f697d6938b6c2p-1), UNIT(-0x1.f838b8c811c17p-1), UNIT(-0x1.f9b24942fe45bp-1),
+        UNIT(-0x1.fb046a9309479p-1), UNIT(-0x1.fc2f025a23e8cp-1), UNIT(-0x1.fd31f94f867c7p-1),
+        UNIT(-0x1.fe0d3b41815a2p-1), UNIT(-0x1.fec0b7170fff6p-1), UNIT(-0x1.ff4c5ed12e61dp-1),
+        UNIT(-0x1.ffb0278bf0567p-1), UNIT(-0x1.ffec097f5af8ap-1), UNIT(-0x1.0000000000000p+0),
+        UNIT(-0x1.ffec097f5af8ap-1), UNIT(-0x1.ffb0278bf0567p-1), UNIT(-0x1.ff4c5ed12e61dp-1),
+        UNIT(-0x1.fec0b7170fff7p-1), UNIT(-0x1.fe0d3b41815a2p-1), UNIT(-0x1.fd31f94f867c7p-1),
+        UNIT(-0x1.fc2f025a23e8bp-1), UNIT(-0x1.fb046a930947ap-1), UNIT(-0x1.f9b24942fe45cp-1),
+        UNIT(-0x1.f838b8c811c18p-1), UNIT(-0x1.f697d6938b6c1p-1), UNIT(-0x1.f4cfc327a007fp-1),
+        UNIT(-0x1.f2e0a214e870fp-1), UNIT(-0x1.f0ca99f79ba26p-1), UNIT(-0x1.ee8dd4748bf16p-1),
+        UNIT(-0x1.ec2a7e35e7b7fp-1), UNIT(-0x1.e9a0c6e7bdb1fp-1), UNIT(-0x1.e6f0e13445500p-1),
+        UNIT(-0x1.e41b02bfeb4ccp-1), UNIT(-0x1.e11f642522d1bp-1), UNIT(-0x1.ddfe40effb805p-1),
+        UNIT(-0x1.dab7d7997cb58p-1), UNIT(-0x1.d74c6982c6670p-1), UNIT(-0x1.d3bc3aeff7f97p-1),
+        UNIT(-0x1.d0079302dd767p-1), UNIT(-0x1.cc2ebbb5638cap-1), UNIT(-0x1.c83201d3d2c6ep-1),
+        UNIT(-0x1.c411b4f6d2709p-1), UNIT(-0x1.bfce277d339c5p-1), UNIT(-0x1.bb67ae8584caap-1),
+        UNIT(-0x1.b6dea1e76eadep-1), UNIT(-0x1.b2335c2cda947p-1), UNIT(-0x1.ad663a8ae2fdep-1),
+        UNIT(-0x1.a8779cda8eea4p-1), UNIT(-0x1.a367e59158747p-1), UNIT(-0x1.9e3779b97f4a9p-1),
+        UNIT(-0x1.98e6c0ea27a16p-1), UNIT(-0x1.9376253f463d0p-1), UNIT(-0x1.8de613515a327p-1),
+        UNIT(-0x1.8836fa2cf503ap-1), UNIT(-0x1.82694b4a11c39p-1), UNIT(-0x1.7c7d7a833bec5p-1),
+        UNIT(-0x1.7673fe0c86981p-1), UNIT(-0x1.704d4e6a54d39p-1), UNIT(-0x1.6a09e667f3bcep-1),
+        UNIT(-0x1.63aa430e07313p-1), UNIT(-0x1.5d2ee398c9c29p-1), UNIT(-0x1.5698496e20bd7p-1),
+        UNIT(-0x1.4fe6f81384fd5p-1), UNIT(-0x1.491b7523c161fp-1), UNIT(-0x1.4236484487ac1p-1),
+        UNIT(-0x1.3b37fb1bdc938p-1), UNIT(-0x1.342119455beb6p-1), UNIT(-0x1.2cf2304755a60p-1),
+        UNIT(-0x1.25abcf87c497cp-1), UNIT(-0x1.1e4e88411fd10p-1), UNIT(-0x1.16daed770771cp-1),
+        UNIT(-0x1.0f5193eacdd2bp-1), UNIT(-0x1.07b3120fddf16p-1), UNIT(-0x1.0000000000004p-1),
+        UNIT(-0x1.f071eedefa0eap-2), UNIT(-0x1.e0bd274245079p-2), UNIT(-0x1.d0e2e2b44de04p-2),
+        UNIT(-0x1.c0e45dabe05cfp-2), UNIT(-0x1.b0c2d7737984fp-2), UNIT(-0x1.a07f921061ad0p-2),
+        UNIT(-0x1.901bd2298ffadp-2), UNIT(-0x1.7f98deee59687p-2), UNIT(-0x1.6ef801fced345p-2),
+        UNIT(-0x1.5e3a8748a0bf3p-2), UNIT(-0x1.4d61bd000cddcp-2), UNIT(-0x1.3c6ef372fe953p-2),
+        UNIT(-0x1.2b637cf83d5cfp-2), UNIT(-0x1.1a40add328e25p-2), UNIT(-0x1.0907dc193068fp-2),
+        UNIT(-0x1.ef74bf2e4b922p-3), UNIT(-0x1.ccb3236cdc681p-3), UNIT(-0x1.a9cd9ac425909p-3),
+        UNIT(-0x1.86c6ddd76624ap-3), UNIT(-0x1.63a1a7e0b738bp-3), UNIT(-0x1.4060b67a8537ep-3),
+        UNIT(-0x1.1d06c968d9e29p-3), UNIT(-0x1.f32d44c4f62c1p-4), UNIT(-0x1.ac2609b3c5768p-4),
+        UNIT(-0x1.64fd6b8c2810dp-4), UNIT(-0x1.1db8f6d6a5140p-4), UNIT(-0x1.acbc748efc95bp-5),
+        UNIT(-0x1.1de58c9f7dc12p-5), UNIT(-0x1.1df0b2b89dd2cp-6)
+};
+
+position_t round_to_extended(position_t position) {
+    unsigned __int128 magnitude = position < 0 ? -(unsigned __int128) position : position;
+    auto high = (uint64_t) (magnitude >> 64);
+    if (high == 0)
+        return position;
+
+    // magnitude is below 2^127, so at most 63 bits are dropped, all from the low half
+    int dropped = 64 - __builtin_clzll(high);
+    uint64_t unit = (uint64_t) 1 << dropped;
+    // adding just under half a unit rounds to nearest, the lowest kept bit decides ties
+    uint64_t odd = ((uint64_t) magnitude >> dropped) & 1;
+    magnitude += unit / 2 - 1 + odd;
+    magnitude &= ~(unsigned __int128) (unit - 1);
+    return position < 0 ? -(position_t) magnitude : (position_t) magnitude;
+}
+
+void WormTable::clear() {
+    x.clear();
+    y.clear();
+    direction.clear();
+    turn_direction.clear();
+    eliminated.clear();
+    moved.clear();
+    pixel_x.clear();
+    pixel_y.clear();
+    last_pixel_x.clear();
+    last_pixel_y.clear();
+}
+
+void WormTable::reserve(size_t count) {
+    x.reserve(count);
+    y.reserve(count);
+    direction.reserve(count);
+    turn_direction.reserve(count);
+    eliminated.reserve(count);
+    moved.reserve(count);
+    pixel_x.reserve(count);
+    pixel_y.reserve(count);
+    last_pixel_x.reserve(count);
+    last_pixel_y.reserve(count);
+}
+
+uint32_t WormTable::add(uint32_t start_x, uint32_t start_y, int32_t start_direction, uint8_t start_turn_direction) {
+    x.push_back(pixel_center(start_x));
+    y.push_back(pixel_center(start_y));
+    direction.push_back(start_direction);
+    turn_direction.push_back(start_turn_direction);
+    eliminated.push_back(false);
+    moved.push_back(false);
+    pixel_x.push_back(start_x);
+    pixel_y.push_back(start_y);
+    last_pixel_x.push_back(start_x);
+    last_pixel_y.push_back(start_y);
+    return direction.size() - 1;
+}
+
+namespace {
+
+/* Directions stay in (-360, 360) and turning speed is below 360, so the remainder of C++ %
+ * (which keeps the sign) is a single correction by 360 either way. Eliminated worms keep
+ * their direction, it is part of the state hash. */
+
+void turn_worms_scalar(WormTable &worms, size_t from, int32_t turning_speed) {
+    for (size_t i = from; i < worms.size(); i++) {
+        if (worms.eliminated[i])
+            continue;
+        if (worms.turn_direction[i] == RIGHT)
+            worms.direction[i] += turning_speed;
+        if (worms.turn_direction[i] == LEFT)
+            worms.direction[i] -= turning_speed;
+        worms.direction[i] %= 360;
+    }
+}
+
+void mark_moved_scalar(WormTable &worms, size_t from) {
+    for (size_t i = from; i < worms.size(); i++)
+        worms.moved[i] = worms.pixel_x[i] != worms.last_pixel_x[i] || worms.pixel_y[i] != worms.last_pixel_y[i];
+}
+
+#ifdef __SSE2__
+
+// four bytes widened to four 32 bit lanes
+__m128i load_bytes(const uint8_t *bytes) {
+    uint32_t packed;
+    memcpy(&packed, bytes, sizeof packed);
+    const __m128i zero = _mm_setzero_si128();
+    return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128((int) packed), zero), zero);
+}
+
+void turn_worms(WormTable &worms, int32_t turning_speed) {
+    const __m128i speed = _mm_set1_epi32(turning_speed);
+    const __m128i right = _mm_set1_epi32(RIGHT);
+    const __m128i left = _mm_set1_epi32(LEFT);
+    const __m128i full_turn = _mm_set1_epi32(360);
+    const __m128i below_full_turn = _mm_set1_epi32(359);
+    const __m128i above_minus_full_turn = _mm_set1_epi32(-359);
+    const __m128i zero = _mm_setzero_si128();
+
+    size_t i = 0;
+    for (; i + 4 <= worms.size(); i += 4) {
+        __m128i turn = load_bytes(&worms.turn_direction[i]);
+        __m128i eliminated = _mm_cmpgt_epi32(load_bytes(&worms.eliminated[i]), zero);
+        __m128i direction = _mm_loadu_si128((const __m128i *) &worms.direction[i]);
+
+        __m128i change = _mm_sub_epi32(_mm_and_si128(_mm_cmpeq_epi32(turn, right), speed),
+                                       _mm_and_si128(_mm_cmpeq_epi32(turn, left), speed));
+        direction = _mm_add_epi32(direction, _mm_andnot_si128(eliminated, change));
+        __m128i too_big = _mm_cmpgt_epi32(direction, below_full_turn);
+        __m128i too_small = _mm_cmpgt_epi32(above_minus_full_turn, direction);
+        direction = _mm_sub_epi32(direction, _mm_and_si128(too_big, full_turn));
+        direction = _mm_add_epi32(direction, _mm_and_si128(too_small, full_turn));
+        _mm_storeu_si128((__m128i *) &worms.direction[i], direction);
+    }
+    turn_worms_scalar(worms, i, turning_speed);
+}
+
+void mark_moved(WormTable &worms) {
+    const __m128i one = _mm_set1_epi8(1);
+
+    size_t i = 0;
+    for (; i + 4 <= worms.size(); i += 4) {
+        __m128i same_x = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *) &worms.pixel_x[i]),
+                                         _mm_loadu_si128((const __m128i *) &worms.last_pixel_x[i]));
+        __m128i same_y = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *) &worms.pixel_y[i]),
+                                         _mm_loadu_si128((const __m128i *) &worms.last_pixel_y[i]));
+        // all ones lanes narrowed to bytes stay all ones
+        __m128i same = _mm_and_si128(same_x, same_y);
+        same = _mm_packs_epi16(_mm_packs_epi32(same, same), same);
+        auto moved = (uint32_t) _mm_cvtsi128_si32(_mm_andnot_si128(same, one));
+        memcpy(&worms.moved[i], &moved, sizeof moved);
+    }
+    mark_moved_scalar(worms, i);
+}
+
+#else
+
+void turn_worms(WormTable &worms, int32_t turning_speed) {
+    turn_worms_scalar(worms, 0, turning_speed);
+}
+
+void mark_moved(WormTable &worms) {
+    mark_moved_scalar(worms, 0);
+}
+
+#endif
+
+}
+
+/* Turning and checking for a new pixel work on 32 bit lanes, four worms at a time. Positions
+ * have to be rounded exactly as the long double sums were, which takes 128 bit arithmetic,
+ * so they are moved one by one, and their 16 byte unit vectors are loaded one by one too. */
+void move_worms(WormTable &worms, uint32_t turning_speed) {
+    turn_worms(worms, (int32_t) turning_speed);
+    for (size_t i = 0; i < worms.size(); i++) {
+        worms.last_pixel_x[i] = worms.pixel_x[i];
+        worms.last_pixel_y[i] = worms.pixel_y[i];
+        if (worms.eliminated[i])
+            continue;
+        worms.x[i] = round_to_extended(worms.x[i] + unit_cos[worms.direction[i] + DIRECTION_OFFSET]);
+        worms.y[i] = round_to_extended(worms.y[i] + unit_sin[worms.direction[i] + DIRECTION_OFFSET]);
+        worms.pixel_x[i] = to_pixel(worms.x[i]);
+        worms.pixel_y[i] = to_pixel(worms.y[i]);
+    }
+    mark_moved(worms);
+}
+
+namespace {
+
+void hash_bytes(crc32_t &rem, unsigned __int128 value, int size) {
+    uint8_t bytes[sizeof value];
+    for (int i = 0; i < size; i++)
+        bytes[i] = value >> (8 * i);
+    rem = crc_update(rem, bytes, size);
+}
+
+}
+
+uint32_t state_hash(const WormTable &worms) {
+    crc32_t rem = crc_start();
+    for (size_t i = 0; i < worms.size(); i++) {
+        hash_bytes(rem, worms.x[i], sizeof(position_t));
+        hash_bytes(rem, worms.y[i], sizeof(position_t));
+        hash_bytes(rem, (uint32_t) worms.direction[i], sizeof(int32_t));
+        hash_bytes(rem, worms.eliminated[i], 1);
+    }
+    return crc_finish(rem);
+}
@@ -0,0 +1,114 @@
+#ifndef ZADANIE2_SIMULATION_H
+#define ZADANIE2_SIMULATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "board.h"
+
+// Positions in fixed point, one pixel is 1 << POSITION_SHIFT. After every step a position is
+// rounded to 64 significant bits, exactly as the x87 long double sums of the original version
+// were, so integer arithmetic alone gives the same pixels on every compiler and architecture.
+#define POSITION_SHIFT 114
+using position_t = __int128;
+
+// directions in degrees, in (-360, 360) as turning left can take them below zero
+#define DIRECTIONS 719
+#define DIRECTION_OFFSET 359
+
+// unit vectors of all directions, index is direction + DIRECTION_OFFSET
+extern const position_t unit_cos[DIRECTIONS];
+extern const position_t unit_sin[DIRECTIONS];
+
+// per tick state of the worms of one game, one array per field, index is the player number
+struct WormTable {
+    std::vector<position_t> x, y;
+    std::vector<int32_t> direction;
+    std::vector<uint8_t> turn_direction;
+    std::vector<uint8_t> eliminated;
+    std::vector<uint8_t> moved; // pixel changed in the last step
+    std::vector<uint32_t> pixel_x, pixel_y;
+    std::vector<uint32_t> last_pixel_x, last_pixel_y; // pixel before the last step
+
+    [[nodiscard]] size_t size() const {
+        return direction.size();
+    }
+
+    void clear();
+
+    void reserve(size_t count);
+
+    // worm in the center of the pixel, returns its number
+    uint32_t add(uint32_t start_x, uint32_t start_y, int32_t start_direction, uint8_t start_turn_direction);
+};
+
+inline position_t pixel_center(uint32_t pixel) {
+    return ((position_t) pixel << POSITION_SHIFT) + ((position_t) 1 << (POSITION_SHIFT - 1));
+}
+
+// truncated toward zero, so positions left of or above the board give values past its size
+inline uint32_t to_pixel(position_t position) {
+    // shifting rounds down, negative positions are moved up by just under a pixel first
+    position_t bias = position < 0 ? ((position_t) 1 << POSITION_SHIFT) - 1 : 0;
+    return (uint32_t) (int64_t) ((position + bias) >> POSITION_SHIFT);
+}
+
+// rounds to 64 significant bits, to nearest, ties to even (position must not be -2^127)
+position_t round_to_extended(position_t position);
+
+// moves every worm which is not eliminated by one step
+void move_worms(WormTable &worms, uint32_t turning_speed);
+
+// hash of positions, directions and eliminations, same on every architecture
+uint32_t state_hash(const WormTable &worms);
+
+/* Rules of the game, shared by the server and lockstep clients. What happens is reported
+ * through on_pixel(x, y, player_no) and on_eliminated(player_no), the game is over once
+ * at most one worm is left. */
+
+inline bool game_over(uint32_t active) {
+    return active <= 1;
+}
+
+// puts the next worm on the board, the worm is eliminated at once if the pixel is eaten
+template<typename OnPixel, typename OnEliminated>
+void place_worm(WormTable &worms, Board &board, uint32_t x, uint32_t y, int32_t direction,
+                uint8_t turn_direction, uint32_t &active, OnPixel on_pixel, OnEliminated on_eliminated) {
+    uint32_t player_no = worms.add(x, y, direction, turn_direction);
+    active++;
+    if (board.eaten(x, y)) {
+        worms.eliminated[player_no] = true;
+        active--;
+        on_eliminated(player_no);
+    } else {
+        board.eat(x, y);
+        on_pixel(x, y, player_no);
+    }
+}
+
+// moves all worms, then in player order every worm which got to a new pixel eats it or is
+// eliminated, false if the game is over (worms after the last but one eliminated don't count)
+template<typename OnPixel, typename OnEliminated>
+bool play_round(WormTable &worms, Board &board, uint32_t turning_speed, uint32_t &active,
+                OnPixel on_pixel, OnEliminated on_eliminated) {
+    move_worms(worms, turning_speed);
+    for (uint32_t i = 0; i < worms.size(); i++) {
+        if (!worms.moved[i])
+            continue;
+        uint32_t x = worms.pixel_x[i];
+        uint32_t y = worms.pixel_y[i];
+        if (x >= board.get_width() || y >= board.get_height() || board.eaten(x, y)) {
+            worms.eliminated[i] = true;
+            active--;
+            on_eliminated(i);
+        } else {
+            board.eat(x, y);
+            on_pixel(x, y, i);
+        }
+        if (game_over(active))
+            return false;
+    }
+    return true;
+}
+
+#endif //ZADANIE2_SIMULATION_H
@@ -0,0 +1,187 @@
+#include <algorithm>
+#include <cstring>
+#include <endian.h>
+#include "compact_events.h"
+#include "snapshot.h"
+
+namespace {
+
+// numbers encoded in the fragments of a snapshot, which may be split between fragments
+class FragmentReader {
+    const EventLog &fragments;
+    uint32_t next_fragment = 0;
+    const uint8_t *in = nullptr, *end = nullptr;
+
+    uint8_t byte() {
+        while (in == end) {
+            EventSlice fragment = fragments.slice(next_fragment++, 1);
+            in = fragment.data + EVENT_HEADER_SIZE + sizeof(snapshot_data_mess);
+            end = fragment.data + fragment.len - sizeof(crc32_t);
+        }
+        return *in++;
+    }
+
+public:
+    explicit FragmentReader(const EventLog &fragments) : fragments(fragments) {}
+
+    [[nodiscard]] bool at_end() const {
+        return in == end && next_fragment == fragments.size();
+    }
+
+    uint32_t number() {
+        uint32_t value = 0;
+        for (int shift = 0;; shift += 7) {
+            uint8_t next = byte();
+            value |= (uint32_t) (next & 0x7f) << shift;
+            if (!(next & 0x80))
+                return value;
+        }
+    }
+
+    void skip(uint32_t numbers) {
+        for (uint32_t i = 0; i < numbers; i++)
+            number();
+    }
+};
+
+// counts bytes of the encoding
+struct ByteCounter {
+    size_t size = 0;
+
+    void put(uint32_t number) {
+        uint8_t buffer[MAX_VARINT_LEN];
+        size += write_varint(buffer, number) - buffer;
+    }
+};
+
+// cuts the encoding into count fragments appended to the log
+class FragmentWriter {
+    EventLog &fragments;
+    uint32_t event_no;
+    uint32_t count;
+    uint8_t data[sizeof(snapshot_data_mess) + SNAPSHOT_FRAGMENT_LEN];
+    size_t used = 0; // after the fragment numbers
+
+public:
+    FragmentWriter(EventLog &fragments, uint32_t event_no, uint32_t count) :
+            fragments(fragments), event_no(event_no), count(count) {}
+
+    void put(uint32_t number) {
+        uint8_t buffer[MAX_VARINT_LEN];
+        uint8_t *buffer_end = write_varint(buffer, number);
+        for (uint8_t *byte = buffer; byte < buffer_end; byte++) {
+            data[sizeof(snapshot_data_mess) + used++] = *byte;
+            if (used == SNAPSHOT_FRAGMENT_LEN)
+                flush();
+        }
+    }
+
+    void flush() {
+        if (used == 0)
+            return;
+        snapshot_data_mess numbers{htobe32(fragments.size()), htobe32(count)};
+        memcpy(data, &numbers, sizeof numbers);
+        fragments.append_as(event_no, SNAPSHOT_TYPE, data, sizeof numbers + used);
+        used = 0;
+    }
+};
+
+}
+
+void Snapshot::clear(uint32_t board_width) {
+    width = board_width;
+    for (auto &log : fragments)
+        log.clear();
+    event_no = 0;
+}
+
+template<typename Sink>
+void Snapshot::encode(const WormTable &worms, const std::vector<Pixel> &fresh, Sink &sink) const {
+    uint32_t eliminated = std::count(worms.eliminated.begin(), worms.eliminated.end(), true);
+    sink.put(eliminated);
+    for (uint32_t i = 0; i < worms.size(); i++) {
+        if (worms.eliminated[i])
+            sink.put(i);
+    }
+    sink.put(worms.size() - eliminated);
+    for (uint32_t i = 0; i < worms.size(); i++) {
+        if (!worms.eliminated[i]) {
+            sink.put(i);
+            sink.put(worms.pixel_x[i]);
+            sink.put(worms.pixel_y[i]);
+        }
+    }
+
+    // runs of the previous snapshot come after its worms
+    FragmentReader previous(fragments[current]);
+    if (!previous.at_end()) {
+        previous.skip(previous.number());
+        previous.skip(3 * previous.number());
+    }
+    uint32_t old_end = 0, old_left = 0, old_player = 0; // pixels of the old run not merged yet
+
+    Pixel run{0, 0};
+    uint32_t run_len = 0;
+    uint32_t end = 0; // pixel after the previous run
+    auto fresh_pixel = fresh.begin();
+    while (true) {
+        if (old_left == 0 && !previous.at_end()) {
+            old_end += previous.number();
+            old_left = previous.number();
+            old_player = previous.number();
+        }
+        Pixel pixel{};
+        if (old_left > 0 && (fresh_pixel == fresh.end() || old_end < fresh_pixel->index)) {
+            pixel = {old_end++, old_player};
+            old_left--;
+        } else if (fresh_pixel != fresh.end()) {
+            pixel = *fresh_pixel++;
+        } else {
+            break;
+        }
+        if (run_len > 0 && pixel.index == run.index + run_len && pixel.player == run.player) {
+            run_len++;
+            continue;
+        }
+        if (run_len > 0) {
+            sink.put(run.index - end);
+            sink.put(run_len);
+            sink.put(run.player);
+            end = run.index + run_len;
+        }
+        run = pixel;
+        run_len = 1;
+    }
+    if (run_len > 0) {
+        sink.put(run.index - end);
+        sink.put(run_len);
+        sink.put(run.player);
+    }
+}
+
+void Snapshot::take(const EventLog &events, uint32_t next_event, const WormTable &worms) {
+    // pixels eaten since the previous snapshot, or since the start
+    std::vector<Pixel> fresh;
+    for (uint32_t event = event_no; event < next_event; event++) {
+        LoggedEvent logged = events.event(event);
+        if (logged.type != PIXEL_TYPE)
+            continue;
+        pixel_data_v2_mess pixel;
+        memcpy(&pixel, logged.data, sizeof pixel);
+        fresh.push_back({be32toh(pixel.y) * width + be32toh(pixel.x), be16toh(pixel.player_number)});
+    }
+    auto by_index = [](const Pixel &p1, const Pixel &p2) { return p1.index < p2.index; };
+    std::sort(fresh.begin(), fresh.end(), by_index);
+
+    // the number of fragments goes into every one of them, so the encoding is done twice
+    ByteCounter counter;
+    encode(worms, fresh, counter);
+    EventLog &next = fragments[1 - current];
+    next.clear();
+    FragmentWriter writer(next, next_event, (counter.size + SNAPSHOT_FRAGMENT_LEN - 1) / SNAPSHOT_FRAGMENT_LEN);
+    encode(worms, fresh, writer);
+    writer.flush();
+
+    current = 1 - current;
+    event_no = next_event;
+}
@@ -0,0 +1,53 @@
+#ifndef ZADANIE2_SNAPSHOT_H
+#define ZADANIE2_SNAPSHOT_H
+
+#include <cstdint>
+#include <vector>
+#include "communication.h"
+#include "event_log.h"
+#include "simulation.h"
+
+// snapshot bytes in one fragment, after game id, event header and fragment numbers
+#define SNAPSHOT_FRAGMENT_LEN (MAX_HOST_MESS_LEN - sizeof(uint32_t) - EVENT_HEADER_META - sizeof(snapshot_data_mess))
+
+// The latest snapshot of one game. Pixels eaten after it are read from the v2 events and
+// merged in (and the whole snapshot encoded again) once a newer snapshot is needed. Pixels of
+// the snapshot are only in its fragments, which are read back for the merge, so like events
+// they are kept in memory only as far as EventLog::resident_limit allows.
+class Snapshot {
+    struct Pixel {
+        uint32_t index; // y * width + x
+        uint32_t player;
+    };
+
+    uint32_t width = 0;
+    EventLog fragments[2]; // all of them numbered with event_no, the snapshot and the previous one
+    int current = 0;
+    uint32_t event_no = 0; // first event after the snapshot, 0 if there is none
+
+    // puts worms and pixels of the snapshot merged with fresh ones (sorted) through sink.put(number)
+    template<typename Sink>
+    void encode(const WormTable &worms, const std::vector<Pixel> &fresh, Sink &sink) const;
+
+public:
+    [[nodiscard]] uint32_t first_event() const {
+        return event_no;
+    }
+
+    [[nodiscard]] uint32_t fragments_count() const {
+        return fragments[current].size();
+    }
+
+    void clear(uint32_t board_width);
+
+    // takes a snapshot of the game before event next_event of the v2 events, worms are the
+    // state at that time
+    void take(const EventLog &events, uint32_t next_event, const WormTable &worms);
+
+    // longest run of fragments starting with first which fits in a datagram
+    [[nodiscard]] EventSlice fragments_from(uint32_t first) const {
+        return fragments[current].slice(first, MAX_HOST_MESS_LEN - sizeof(uint32_t));
+    }
+};
+
+#endif //ZADANIE2_SNAPSHOT_H
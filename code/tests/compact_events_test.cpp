@@ -0,0 +1,193 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <endian.h>
+#include <random>
+#include <vector>
+#include "../compact_events.h"
+#include "../err.h"
+
+#define VARINTS 100000
+#define GAMES 20
+#define MAX_PLAYERS 25
+#define MAX_GAME_EVENTS 20000
+#define LOOKUPS 2000
+
+// varints of every length and their ends, against the value and length they should have, returns mismatches
+int check_varints() {
+    std::mt19937 random(2021);
+    int mismatches = 0;
+    uint8_t buffer[MAX_VARINT_LEN + 1];
+    for (int i = 0; i < VARINTS; i++) {
+        uint32_t value = i < 64 ? (i % 2 == 0 ? (1u << (i / 2)) : (1u << (i / 2)) - 1) : random() >> (random() % 32);
+        uint32_t expected_len = 1;
+        while (expected_len < MAX_VARINT_LEN && value >> (7 * expected_len) != 0)
+            expected_len++;
+
+        uint8_t *end = write_varint(buffer, value);
+        mismatches += end - buffer != expected_len;
+        const uint8_t *in = buffer;
+        uint32_t read;
+        mismatches += !read_varint(in, end, read) || in != end || read != value;
+        in = buffer;
+        mismatches += read_varint(in, end - 1, read); // cut short
+    }
+    memset(buffer, 0x80, sizeof buffer);
+    const uint8_t *in = buffer;
+    uint32_t read;
+    mismatches += read_varint(in, buffer + sizeof buffer, read); // longer than a number can be
+    printf("varints: %d numbers, %d mismatches\n", VARINTS, mismatches);
+    return mismatches;
+}
+
+struct test_event {
+    uint8_t type;
+    uint32_t player, x, y;
+    std::vector<uint8_t> data;
+    bool step; // previous pixel of the player is known and next to it
+    uint32_t step_x, step_y;
+};
+
+// events of a random game in the order they are recorded
+std::vector<test_event> random_game(std::mt19937 &random) {
+    uint32_t players = 1 + random() % MAX_PLAYERS;
+    std::vector<test_event> events;
+    std::vector<uint8_t> data(random() % 200);
+    for (auto &byte : data)
+        byte = random();
+    events.push_back({NEW_GAME_TYPE, players, 0, 0, data, false, 0, 0});
+    if (random() % 2)
+        events.push_back({PLAYER_NAMES_TYPE, 0, 0, 0, std::vector<uint8_t>(data.rbegin(), data.rend()), false, 0, 0});
+
+    struct last_pixel {
+        uint32_t x, y;
+        bool known;
+    };
+    std::vector<last_pixel> last(players, {0, 0, false});
+    uint32_t count = random() % MAX_GAME_EVENTS;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t player = random() % players;
+        if (random() % 100 == 0) {
+            events.push_back({ELIMINATED_TYPE, player, 0, 0, {}, false, 0, 0});
+            continue;
+        }
+        auto &pixel = last[player];
+        uint32_t x = pixel.x + random() % 5 - 2, y = pixel.y + random() % 5 - 2;
+        if (!pixel.known || random() % 10 == 0) {
+            x = random() >> (random() % 32);
+            y = random() >> (random() % 32);
+        }
+        int64_t dx = (int64_t) x - pixel.x, dy = (int64_t) y - pixel.y;
+        bool step = pixel.known && -1 <= dx && dx <= 1 && -1 <= dy && dy <= 1;
+        events.push_back({PIXEL_TYPE, player, x, y, {}, step, pixel.x, pixel.y});
+        pixel = {x, y, true};
+    }
+    if (random() % 2)
+        events.push_back({END_GAME_TYPE, 0, 0, 0, {}, false, 0, 0});
+    return events;
+}
+
+void record(CompactStream &stream, const test_event &event) {
+    switch (event.type) {
+        case NEW_GAME_TYPE:
+            stream.new_game(event.data.data(), event.data.size(), event.player);
+            return;
+        case PLAYER_NAMES_TYPE:
+            stream.player_names(event.data.data(), event.data.size());
+            return;
+        case PIXEL_TYPE:
+            stream.pixel(event.player, event.x, event.y);
+            return;
+        case ELIMINATED_TYPE:
+            stream.eliminated(event.player);
+            return;
+        default:
+            stream.end_game();
+    }
+}
+
+// one record as the client parses it, false if it isn't the event it was made from
+bool parse_record(const uint8_t *&record, const uint8_t *end, const test_event &event) {
+    uint8_t tag = *record++;
+    uint32_t player, x, y, len;
+    if (COMPACT_PIXEL_STEP <= tag && tag < COMPACT_PIXEL_STEP + 9) {
+        int32_t dx = (tag - COMPACT_PIXEL_STEP) / 3 - 1, dy = (tag - COMPACT_PIXEL_STEP) % 3 - 1;
+        return read_varint(record, end, player) && event.type == PIXEL_TYPE && event.step && player == event.player &&
+               event.step_x + dx == event.x && event.step_y + dy == event.y;
+    }
+    if (tag != event.type)
+        return false;
+    switch (tag) {
+        case NEW_GAME_TYPE:
+        case PLAYER_NAMES_TYPE:
+            if (!read_varint(record, end, len) || len > (uint32_t) (end - record))
+                return false;
+            record += len;
+            return event.data == std::vector<uint8_t>(record - len, record);
+        case PIXEL_TYPE:
+            return read_varint(record, end, player) && read_varint(record, end, x) && read_varint(record, end, y) &&
+                   !event.step && player == event.player && x == event.x && y == event.y;
+        case ELIMINATED_TYPE:
+            return read_varint(record, end, player) && player == event.player;
+        default:
+            return true;
+    }
+}
+
+// datagram with its header and crc checked and every record parsed, false if anything differs
+bool check_datagram(const CompactDatagram &datagram, const std::vector<test_event> &events) {
+    uint32_t event_no = be32toh(datagram.header.first_event_no);
+    crc32_t rem = crc_update(crc_start(), (const uint8_t *) &datagram.header, sizeof datagram.header);
+    rem = crc_update(rem, datagram.records.data, datagram.records.len);
+    if (datagram.header.marker != COMPACT_MARKER || event_no != datagram.records.first ||
+        be32toh(datagram.crc) != crc_finish(rem) || datagram.records.len > COMPACT_RECORDS_LEN)
+        return false;
+
+    const uint8_t *record = datagram.records.data, *end = record + datagram.records.len;
+    uint32_t parsed = 0;
+    for (; record < end; parsed++, event_no++) {
+        if (event_no >= events.size() || !parse_record(record, end, events[event_no]))
+            return false;
+    }
+    return parsed == datagram.records.events && parsed > 0 && record == end;
+}
+
+// random games sent from every event and from the cache, returns mismatches
+int check_streams() {
+    std::mt19937 random(2021);
+    CompactStream stream;
+    int mismatches = 0;
+    uint32_t datagrams = 0;
+    for (int game = 0; game < GAMES; game++) {
+        std::vector<test_event> events = random_game(random);
+        stream.clear();
+        for (auto &event : events)
+            record(stream, event);
+        if (stream.size() != events.size()) {
+            mismatches++;
+            continue;
+        }
+
+        for (uint32_t first = 0; first < events.size(); datagrams++) {
+            CompactDatagram datagram = stream.datagram_from(first);
+            mismatches += !check_datagram(datagram, events);
+            first += std::max<uint32_t>(datagram.records.events, 1);
+        }
+        for (int i = 0; i < LOOKUPS; i++) {
+            uint32_t first = random() % events.size();
+            CompactDatagram datagram = stream.datagram(first);
+            mismatches += !check_datagram(datagram, events) || datagram.records.first > first ||
+                          datagram.records.first + datagram.records.events <= first;
+        }
+    }
+    printf("compact streams: %d games, %u datagrams, %d lookups, %d mismatches\n",
+           GAMES, datagrams, GAMES * LOOKUPS, mismatches);
+    return mismatches;
+}
+
+int main() {
+    int mismatches = check_varints() + check_streams();
+    if (mismatches != 0)
+        fatal("COMPACT RECORDS DON'T PARSE BACK");
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <random>
+#include "../connection_table.h"
+#include "../err.h"
+
+#define OPERATIONS 200000
+#define CAPACITY 50
+
+using key_bytes = std::array<uint8_t, sizeof(ClientKey::bytes)>;
+
+key_bytes bytes_of(const ClientKey &key) {
+    key_bytes bytes;
+    memcpy(bytes.data(), key.bytes, bytes.size());
+    return bytes;
+}
+
+// few addresses and ports, so keys collide often, IPv4 ones sent as they are or mapped to IPv6
+ClientKey random_key(std::mt19937 &random) {
+    uint8_t host = random() % 12;
+    uint16_t port = htons(random() % 8);
+    if (random() % 2) {
+        sockaddr_in6 address{};
+        address.sin6_family = AF_INET6;
+        address.sin6_port = port;
+        address.sin6_addr.s6_addr[15] = host;
+        address.sin6_addr.s6_addr[0] = random() % 2 ? 0x20 : 0;
+        if (address.sin6_addr.s6_addr[0] == 0)
+            address.sin6_addr.s6_addr[10] = address.sin6_addr.s6_addr[11] = 0xff;
+        return ClientKey::from((sockaddr *) &address);
+    }
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = port;
+    address.sin_addr.s_addr = htonl(host);
+    return ClientKey::from((sockaddr *) &address);
+}
+
+// random inserts and erases against a map, every step checks a lookup, returns mismatches
+int check(uint64_t seed) {
+    std::mt19937 random(seed);
+    ConnectionTable table(CAPACITY, seed);
+    std::map<key_bytes, uint32_t> players;
+    int mismatches = 0;
+    for (uint32_t i = 0; i < OPERATIONS; i++) {
+        ClientKey key = random_key(random);
+        auto it = players.find(bytes_of(key));
+        Connection *connection = table.find(key);
+        if ((connection != nullptr) != (it != players.end()) || (connection != nullptr && connection->player != it->second)) {
+            mismatches++;
+            continue;
+        }
+        if (random() % 2 == 0) {
+            if (connection == nullptr && !table.full()) {
+                Connection &inserted = table.insert(key, i);
+                sockaddr_in6 address = key.to_address();
+                mismatches += memcmp(&inserted.address, &address, sizeof address) != 0;
+                players[bytes_of(key)] = i;
+            }
+        } else if (connection != nullptr) {
+            table.erase(key);
+            players.erase(it);
+        }
+        mismatches += table.size() != players.size() || table.full() != (players.size() == CAPACITY);
+    }
+    std::map<key_bytes, uint32_t> iterated;
+    for (auto &connection : table)
+        iterated[bytes_of(connection.key)] = connection.player;
+    mismatches += iterated != players;
+    printf("connection table (seed %lu): %d operations, %d mismatches\n", (unsigned long) seed, OPERATIONS, mismatches);
+    return mismatches;
+}
+
+int main() {
+    int mismatches = 0;
+    for (uint64_t seed : {1, 123, 2021})
+        mismatches += check(seed);
+    if (mismatches != 0)
+        fatal("CONNECTION TABLE LOSES CONNECTIONS");
+    return 0;
+}
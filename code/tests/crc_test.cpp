@@ -0,0 +1,68 @@
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "../crc.h"
+#include "../err.h"
+
+#define BUFFERS 20000
+#define MAX_LEN 4800
+#define MAX_OFFSET 16
+
+/* the original bit at a time version, as in wikipedia https://en.wikipedia.org/wiki/Computation_of_cyclic_redundancy_checks */
+crc32_t crc_reference(const uint8_t *message, uint32_t size) {
+    crc32_t rem = -1;
+    for (uint32_t i = 0; i < size; i++) {
+        rem ^= message[i];
+        for (int j = 0; j < 8; j++) {
+            if (rem & 1) {
+                rem = (rem >> 1) ^ 0xEDB88320;
+            } else {
+                rem = rem >> 1;
+            }
+        }
+    }
+    return ~rem;
+}
+
+// random buffers at random offsets, whole and cut into up to four updates, returns mismatches
+int check(const char *implementation) {
+    std::mt19937 random(2021);
+    std::vector<uint8_t> memory(MAX_LEN + MAX_OFFSET);
+    int mismatches = 0;
+    for (int i = 0; i < BUFFERS; i++) {
+        uint32_t len = random() % (MAX_LEN + 1), offset = random() % MAX_OFFSET;
+        uint8_t *data = memory.data() + offset;
+        for (uint32_t j = 0; j < len; j++)
+            data[j] = random();
+        crc32_t expected = crc_reference(data, len);
+
+        if (crc_cacl(data, len) != expected)
+            mismatches++;
+
+        crc32_t rem = crc_start();
+        uint32_t done = 0;
+        for (int part = random() % 4; part > 0 && done < len; part--) {
+            uint32_t size = random() % (len - done + 1);
+            rem = crc_update(rem, data + done, size);
+            done += size;
+        }
+        rem = crc_update(rem, data + done, len - done);
+        if (crc_finish(rem) != expected)
+            mismatches++;
+    }
+    printf("crc %s: %d buffers, %d mismatches\n", implementation, BUFFERS, mismatches);
+    return mismatches;
+}
+
+int main() {
+    int mismatches = 0;
+    if (crc_uses_clmul())
+        mismatches += check("pclmul");
+    else
+        printf("crc pclmul: not supported here, skipped\n");
+    crc_force_slicing();
+    mismatches += check("slicing-by-8");
+    if (mismatches != 0)
+        fatal("CRC DIFFERS FROM THE BIT AT A TIME VERSION");
+    return 0;
+}
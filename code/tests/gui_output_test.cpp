@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "../gui_output.h"
+#include "../err.h"
+
+#define LINES 200000
+#define MAX_WRITE 300
+
+int failures = 0;
+
+void expect(bool ok, const char *what) {
+    if (!ok) {
+        printf("gui output: %s FAILED\n", what);
+        failures++;
+    }
+}
+
+std::string waiting(const GuiOutput &output) {
+    return std::string(output.data(), output.size());
+}
+
+// lines written by a GUI taking random parts, with the buffer compacting on the way, against the lines given
+void check_partial_writes() {
+    std::mt19937 random(2021);
+    std::vector<std::string> names{"alice", "bob", "carol"};
+    GuiOutput output;
+    std::string expected, written;
+    for (int i = 0; i < LINES; i++) {
+        uint32_t x = random() % 4000, y = random() % 4000;
+        const std::string &name = names[random() % names.size()];
+        switch (random() % 100) {
+            case 0:
+                output.new_game(x, y, names);
+                expected += "NEW_GAME " + std::to_string(x) + " " + std::to_string(y) + " alice bob carol\n";
+                break;
+            case 1:
+                output.eliminated(name);
+                expected += "PLAYER_ELIMINATED " + name + "\n";
+                break;
+            default:
+                output.pixel(x, y, name);
+                expected += "PIXEL " + std::to_string(x) + " " + std::to_string(y) + " " + name + "\n";
+        }
+        if (random() % 4 == 0) {
+            size_t len = std::min<size_t>(random() % MAX_WRITE, output.size());
+            written.append(output.data(), len);
+            output.consume(len);
+        }
+    }
+    written += waiting(output);
+    output.consume(output.size());
+    expect(written == expected, "partial writes");
+    expect(output.size() == 0, "everything written");
+    printf("gui output: %d lines written a part at a time\n", LINES);
+}
+
+// finished games are dropped only when a NEW_GAME waits, and never a line the GUI got a part of
+void check_skip_finished_games() {
+    std::vector<std::string> names{"a", "b"};
+    GuiOutput output;
+    output.new_game(10, 10, names);
+    output.pixel(1, 2, "a");
+    output.pixel(3, 4, "b");
+    expect(!output.skip_finished_games(), "one game is not skipped");
+
+    output.consume(5);
+    output.eliminated("a");
+    output.new_game(20, 20, names);
+    output.pixel(5, 6, "a");
+    expect(output.skip_finished_games(), "game after a partly written line is skipped");
+    expect(waiting(output) == "AME 10 10 a b\nNEW_GAME 20 20 a b\nPIXEL 5 6 a\n", "rest of the line is kept");
+    output.consume(output.size());
+    expect(output.size() == 0, "buffer is empty");
+
+    output.new_game(1, 1, names);
+    output.pixel(0, 0, "a");
+    output.consume(waiting(output).find('\n') + 1);
+    output.new_game(2, 2, names);
+    for (uint32_t i = 0; i < 2000; i++)
+        output.pixel(i, i, "b");
+    expect(output.skip_finished_games(), "game after whole lines is skipped");
+    expect(waiting(output).rfind("NEW_GAME 2 2 a b\n", 0) == 0, "new game comes first");
+
+    output.consume(3);
+    expect(!output.skip_finished_games(), "partly written new game is not skipped");
+    for (uint32_t i = 0; i < 5000; i++)
+        output.pixel(i, i, "a");
+    expect(!output.skip_finished_games(), "compaction forgets a partly written new game");
+    expect(waiting(output).rfind("_GAME 2 2 a b\n", 0) == 0, "compaction keeps the rest of the line");
+    printf("gui output: skipping finished games\n");
+}
+
+int main() {
+    check_partial_writes();
+    check_skip_finished_games();
+    if (failures != 0)
+        fatal("GUI OUTPUT IS WRONG");
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <random>
+#include <string>
+#include "../reorder_buffer.h"
+#include "../err.h"
+
+#define OPERATIONS 200000
+#define MAX_EVENT 300
+
+// random datagram of event first_event, which starts with it so a taken one tells where it came from
+std::string make_datagram(uint32_t first_event, std::mt19937 &random) {
+    std::string datagram(sizeof first_event + random() % (MAX_HOST_MESS_LEN - sizeof first_event + 1), 0);
+    memcpy(&datagram[0], &first_event, sizeof first_event);
+    for (size_t i = sizeof first_event; i < datagram.size(); i++)
+        datagram[i] = (char) random();
+    return datagram;
+}
+
+// random keeps and takes against a map of the datagrams which should be kept, returns mismatches
+int check() {
+    std::mt19937 random(2021);
+    ReorderBuffer buffer;
+    std::map<uint32_t, std::string> kept;
+    static char taken[MAX_HOST_MESS_LEN];
+    int mismatches = 0;
+    for (int i = 0; i < OPERATIONS; i++) {
+        uint32_t event_no = 1 + random() % MAX_EVENT;
+        switch (random() % 8) {
+            case 0: {
+                int32_t size = buffer.take(event_no, taken);
+                auto nearest = kept.begin();
+                if (size < 0) {
+                    mismatches += nearest != kept.end() && nearest->first <= event_no;
+                    break;
+                }
+                uint32_t first_event;
+                memcpy(&first_event, taken, sizeof first_event);
+                auto it = kept.find(first_event);
+                if (it == kept.end() || first_event > event_no || it->second != std::string(taken, size)) {
+                    mismatches++;
+                    break;
+                }
+                kept.erase(it);
+                break;
+            }
+            case 1:
+                if (random() % 1000 == 0) {
+                    buffer.clear();
+                    kept.clear();
+                }
+                break;
+            default: {
+                std::string datagram = make_datagram(event_no, random);
+                bool expected = kept.count(event_no) == 0 &&
+                                (kept.size() < REORDER_DATAGRAMS || kept.rbegin()->first > event_no);
+                if (buffer.keep(event_no, datagram.data(), datagram.size()) != expected) {
+                    mismatches++;
+                    break;
+                }
+                if (!expected)
+                    break;
+                if (kept.size() == REORDER_DATAGRAMS)
+                    kept.erase(std::prev(kept.end()));
+                kept[event_no] = datagram;
+            }
+        }
+        mismatches += buffer.gap_end() != (kept.empty() ? 0 : kept.begin()->first);
+    }
+    printf("reorder buffer: %d operations, %d mismatches\n", OPERATIONS, mismatches);
+    return mismatches;
+}
+
+int main() {
+    if (check() != 0)
+        fatal("REORDER BUFFER KEEPS WRONG DATAGRAMS");
+    return 0;
+}
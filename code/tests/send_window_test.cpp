@@ -0,0 +1,131 @@
+#include <cstdio>
+#include <map>
+#include <random>
+#include <vector>
+#include "../send_window.h"
+#include "../err.h"
+
+#define EVENTS 5000
+#define ROUND_US 20000
+#define ROUND_EVENTS 10
+#define DATAGRAM_EVENTS 25
+#define HEARTBEAT_US 20000
+#define MAX_LAG_US 1000000 // after the last round, till the client has everything
+
+int failures = 0;
+
+void expect(bool ok, const char *what) {
+    if (!ok) {
+        printf("send window: %s FAILED\n", what);
+        failures++;
+    }
+}
+
+// round trips, timeouts, holes and starting over, step by step
+void check_steps() {
+    SendWindow window;
+    expect(window.rto() == RTO_INITIAL && window.acknowledged() == 0 && window.sent_until() == 0, "fresh window");
+
+    window.sent_to(10, 0);
+    window.sent_to(20, 0);
+    window.acknowledge(10, 0, 50000);
+    expect(window.acknowledged() == 10 && window.rto() == 150000, "first round trip");
+    window.acknowledge(20, 0, 60000);
+    expect(window.rto() == 51250 + 4 * 21250, "smoothed round trip");
+    window.acknowledge(15, 0, 60000);
+    window.acknowledge(30, 0, 60000);
+    expect(window.acknowledged() == 20, "late and unsent acknowledgements are ignored");
+
+    uint64_t rto = window.rto();
+    window.sent_to(30, 100000);
+    expect(!window.retransmit_if_due(100000 + rto - 1, false), "no retransmission before the timeout");
+    expect(window.retransmit_if_due(100000 + rto, false), "retransmission after the timeout");
+    expect(window.sent_until() == 20 && window.resending(25) && !window.resending(30), "resending the flight");
+    window.sent_to(30, 300000);
+    window.acknowledge(30, 0, 300010);
+    expect(window.rto() == rto, "resent flights tell nothing about round trips");
+
+    window.sent_to(40, 400000);
+    window.sent_to(50, 400000);
+    window.sent_to(60, 400000);
+    window.acknowledge(40, 50, 400001);
+    expect(window.retransmit_if_due(400001, false), "reported hole is resent at once");
+    expect(window.sent_until() == 40 && window.resending(45) && !window.resending(50), "only the hole is resent");
+    window.sent_to(50, 400002);
+    expect(window.sent_until() == 60, "sending goes on after the hole");
+    window.acknowledge(40, 50, 400003);
+    expect(!window.retransmit_if_due(400003, false), "hole is resent only once a round trip");
+    window.acknowledge(50, 55, 400004);
+    expect(window.retransmit_if_due(400004, false) && window.sent_until() == 50, "next hole is resent at once");
+    expect(window.retransmit_if_due(400004, true) && window.resending(55), "hurry resends everything");
+
+    rto = window.rto();
+    window.acknowledge(0, 0, 500000);
+    expect(window.acknowledged() == 0 && window.sent_until() == 0 && window.rto() == rto, "starting over");
+
+    expect(++window.fragments_sent(5) == 1 && window.fragments_sent(5) == 1 && window.fragments_sent(6) == 0,
+           "snapshot fragments");
+
+    Pacer pacer;
+    pacer.reset(0);
+    expect(pacer.take(PACE_BURST, 0) && !pacer.take(1, 0), "pacer burst");
+    expect(pacer.take(PACE_RATE, 1) && !pacer.take(1, 1), "pacer rate");
+    printf("send window: steps\n");
+}
+
+// a game growing every round sent over a link losing a fifth of datagrams and reordering them,
+// as the server sends it, the client has to keep up with it, returns failures
+int check_lossy_link(uint32_t seed) {
+    std::mt19937 random(seed);
+    SendWindow window;
+    std::vector<bool> received(EVENTS);
+    uint32_t next_event = 0;
+    std::multimap<uint64_t, std::pair<uint32_t, uint32_t>> to_client; // arrival -> events
+    std::multimap<uint64_t, std::pair<uint32_t, uint32_t>> to_server; // arrival -> next event, held from
+    uint32_t sent = 0, retransmissions = 0;
+    int mismatches = 0;
+    uint64_t now = 0;
+    uint64_t end = (uint64_t) EVENTS / ROUND_EVENTS * ROUND_US + MAX_LAG_US;
+    for (; now < end && window.acknowledged() < EVENTS; now += 1000) {
+        uint32_t size = std::min<uint64_t>(EVENTS, now / ROUND_US * ROUND_EVENTS);
+        for (uint32_t first = window.sent_until(); first < size; first = window.sent_until()) {
+            uint32_t end = std::min(first + DATAGRAM_EVENTS, size);
+            if (random() % 5 != 0)
+                to_client.insert({now + 10000 + random() % 20000, {first, end}});
+            window.sent_to(end, now);
+            sent++;
+        }
+
+        for (auto it = to_client.begin(); it != to_client.end() && it->first <= now; it = to_client.erase(it)) {
+            for (uint32_t i = it->second.first; i < it->second.second; i++)
+                received[i] = true;
+        }
+        while (next_event < EVENTS && received[next_event])
+            next_event++;
+        if (now % HEARTBEAT_US == 0 && random() % 5 != 0) {
+            uint32_t held_from = next_event;
+            while (held_from < EVENTS && !received[held_from])
+                held_from++;
+            to_server.insert({now + 10000 + random() % 20000, {next_event, held_from < EVENTS ? held_from : 0}});
+        }
+
+        for (auto it = to_server.begin(); it != to_server.end() && it->first <= now; it = to_server.erase(it)) {
+            window.acknowledge(it->second.first, it->second.second, now);
+            retransmissions += window.retransmit_if_due(now, false);
+            mismatches += window.acknowledged() > next_event || window.sent_until() < window.acknowledged();
+        }
+    }
+    mismatches += window.acknowledged() != EVENTS;
+    printf("send window (seed %u): %d events in %lu ms, %u datagrams, %u retransmissions, %d mismatches\n",
+           seed, EVENTS, (unsigned long) (now / 1000), sent, retransmissions, mismatches);
+    return mismatches;
+}
+
+int main() {
+    check_steps();
+    for (uint32_t seed : {1, 7, 2021})
+        failures += check_lossy_link(seed);
+    if (failures != 0)
+        fatal("SEND WINDOW DOESN'T DELIVER EVENTS");
+    return 0;
+}
@@ -0,0 +1,158 @@
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../simulation.h"
+#include "../communication.h"
+#include "../gui_output.h"
+#include "../err.h"
+
+#define WORMS 25
+#define WALKS 20
+#define STEPS 4000
+
+/* Worms moved as the original server did, cos and sin every round added to long double
+ * positions, against the fixed point kinematics of simulation.cpp. */
+
+struct reference_worm {
+    long double x, y;
+    int32_t direction;
+};
+
+void reference_step(reference_worm &worm, uint8_t turn_direction, int32_t turning_speed) {
+    if (turn_direction == RIGHT)
+        worm.direction += turning_speed;
+    if (turn_direction == LEFT)
+        worm.direction -= turning_speed;
+    worm.direction = worm.direction % 360;
+
+    double direction_radians = (double) worm.direction * (M_PI / 180.0);
+    worm.x += cos(direction_radians);
+    worm.y += sin(direction_radians);
+}
+
+// exact, every sum of the reference is a multiple of 2^-114
+position_t to_position(long double value) {
+    return (position_t) (value * 0x1p114L);
+}
+
+// random walks of WORMS worms at once, some of them eliminated on the way, returns walks which diverged
+int check_walks(int32_t turning_speed) {
+    std::mt19937 random(turning_speed);
+    int diverged = 0;
+    for (int walk = 0; walk < WALKS; walk++) {
+        WormTable worms;
+        std::vector<reference_worm> reference;
+        for (int i = 0; i < WORMS; i++) {
+            uint32_t x = random() % MAX_WIDTH, y = random() % MAX_HEIGHT;
+            int32_t direction = random() % 360;
+            worms.add(x, y, direction, random() % 3);
+            reference.push_back({(long double) x + 0.5, (long double) y + 0.5, direction});
+        }
+        bool same = true;
+        for (int step = 0; step < STEPS && same; step++) {
+            for (int i = 0; i < WORMS; i++) {
+                if (random() % 16 == 0)
+                    worms.turn_direction[i] = random() % 3;
+                if (random() % 20000 == 0)
+                    worms.eliminated[i] = true;
+            }
+            move_worms(worms, turning_speed);
+            for (int i = 0; i < WORMS; i++) {
+                if (worms.eliminated[i]) {
+                    same = same && !worms.moved[i];
+                    continue;
+                }
+                reference_step(reference[i], worms.turn_direction[i], turning_speed);
+                same = same && worms.x[i] == to_position(reference[i].x) &&
+                       worms.y[i] == to_position(reference[i].y) && worms.direction[i] == reference[i].direction;
+            }
+        }
+        diverged += !same;
+    }
+    printf("turning speed %d: %d walks of %d worms for %d steps, %d diverged\n",
+           turning_speed, WALKS, WORMS, STEPS, diverged);
+    return diverged;
+}
+
+/* Games recorded from the server before the fixed point kinematics, with players which keep
+ * turning the same way from the start, replayed with the same random numbers. */
+
+struct recorded_game {
+    const char *file;
+    uint64_t seed;
+    uint32_t width, height, turning_speed;
+    std::vector<std::string> names;
+    std::vector<uint8_t> turn_directions;
+};
+
+// as in worms-server.cpp
+uint32_t rand_moodle(uint64_t &state) {
+    uint32_t prev = state;
+    state = (uint32_t) ((state * 279410273) % 4294967291);
+    return prev;
+}
+
+std::string replay(const recorded_game &game) {
+    uint64_t random = game.seed;
+    GuiOutput output;
+    WormTable worms;
+    Board board(game.width, game.height);
+    uint32_t active = 0;
+    auto on_pixel = [&](uint32_t x, uint32_t y, uint32_t player_no) { output.pixel(x, y, game.names[player_no]); };
+    auto on_eliminated = [&](uint32_t player_no) { output.eliminated(game.names[player_no]); };
+
+    rand_moodle(random); // game id
+    output.new_game(game.width, game.height, game.names);
+    for (uint32_t i = 0; i < game.names.size(); i++) {
+        uint32_t x = rand_moodle(random) % game.width;
+        uint32_t y = rand_moodle(random) % game.height;
+        int32_t direction = rand_moodle(random) % 360;
+        place_worm(worms, board, x, y, direction, game.turn_directions[i], active, on_pixel, on_eliminated);
+    }
+    bool playing = !game_over(active);
+    while (playing)
+        playing = play_round(worms, board, game.turning_speed, active, on_pixel, on_eliminated);
+    return std::string(output.data(), output.size());
+}
+
+int check_recorded(const std::string &directory) {
+    const std::vector<recorded_game> games = {
+            {"seed-77-2.txt",    77,    300, 200, 7, {"alice", "bob"},      {RIGHT, LEFT}},
+            {"seed-77-4.txt",    77,    300, 200, 7, {"a", "b", "c", "d"}, {RIGHT, LEFT, RIGHT, LEFT}},
+            {"seed-12345-2.txt", 12345, 300, 200, 7, {"alice", "bob"},      {RIGHT, LEFT}},
+            {"seed-12345-4.txt", 12345, 300, 200, 7, {"a", "b", "c", "d"}, {RIGHT, LEFT, RIGHT, LEFT}},
+            {"seed-999-2.txt",   999,   300, 200, 7, {"alice", "bob"},      {RIGHT, LEFT}},
+            {"seed-999-4.txt",   999,   300, 200, 7, {"a", "b", "c", "d"}, {RIGHT, LEFT, RIGHT, LEFT}},
+    };
+    int mismatches = 0;
+    for (auto &game : games) {
+        std::ifstream file(directory + "/" + game.file);
+        if (!file)
+            fatal("CAN'T READ %s/%s", directory.c_str(), game.file);
+        std::stringstream recorded;
+        recorded << file.rdbuf();
+        bool same = replay(game) == recorded.str();
+        printf("recorded game %s: %s\n", game.file, same ? "same" : "DIFFERENT");
+        mismatches += !same;
+    }
+    return mismatches;
+}
+
+int main(int argc, char **argv) {
+    int mismatches = 0;
+#if LDBL_MANT_DIG == 64
+    for (int32_t turning_speed : {1, 6, 7, 45, 90, 180, 359})
+        mismatches += check_walks(turning_speed);
+#else
+    printf("walks: long double is not x87 extended precision here, skipped\n");
+#endif
+    mismatches += check_recorded(argc > 1 ? argv[1] : "tests/golden");
+    if (mismatches != 0)
+        fatal("WORMS MOVE DIFFERENTLY THAN IN THE ORIGINAL VERSION");
+    return 0;
+}
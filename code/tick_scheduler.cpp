@@ -0,0 +1,36 @@
+#include <algorithm>
+#include <ctime>
+#include "tick_scheduler.h"
+
+void TickSchedule::round_started(uint64_t now) {
+    uint64_t jitter = now > deadline ? now - deadline : 0;
+    rounds++;
+    jitter_sum += jitter;
+    jitter_max = std::max(jitter_max, jitter);
+    if (jitter >= period)
+        late++;
+}
+
+void TickSchedule::round_finished(uint64_t started, uint64_t now) {
+    if (now - started > period)
+        overruns++;
+
+    deadline += period;
+    if (now < deadline)
+        return;
+
+    uint64_t behind = (now - deadline) / period + 1; // rounds already due
+    uint64_t to_skip = 0;
+    if (policy == CatchUp::SKIP)
+        to_skip = behind;
+    else if (behind > MAX_BURST_ROUNDS)
+        to_skip = behind - MAX_BURST_ROUNDS;
+    skipped += to_skip;
+    deadline += to_skip * period;
+}
+
+uint64_t monotonic_time_in_microseconds() {
+    timespec time{};
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return 1000000 * (uint64_t) time.tv_sec + time.tv_nsec / 1000;
+}
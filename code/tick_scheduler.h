@@ -0,0 +1,54 @@
+#ifndef ZADANIE2_TICK_SCHEDULER_H
+#define ZADANIE2_TICK_SCHEDULER_H
+
+#include <cstdint>
+
+// what to do with rounds whose time has already passed
+enum class CatchUp {
+    SKIP,  // drop them, next round keeps the original phase (the game gets fewer rounds per second)
+    BURST  // run them back to back, rounds further than MAX_BURST_ROUNDS behind are dropped
+};
+
+#define MAX_BURST_ROUNDS 10
+
+// Absolute deadlines of a periodic loop, all times in microseconds of CLOCK_MONOTONIC.
+// n-th round after restart is due at start + n * period, so sleep overshoot doesn't add up.
+class TickSchedule {
+    uint64_t period;
+    CatchUp policy;
+    uint64_t deadline = 0;
+
+public:
+    uint64_t rounds = 0, late = 0, overruns = 0, skipped = 0;
+    uint64_t jitter_sum = 0, jitter_max = 0; // how long after its deadline a round started
+
+    TickSchedule(uint64_t period, CatchUp policy) : period(period), policy(policy) {}
+
+    [[nodiscard]] uint64_t next_deadline() const {
+        return deadline;
+    }
+
+    // next round one period from now
+    void restart(uint64_t now) {
+        deadline = now + period;
+    }
+
+    // next round right away
+    void start(uint64_t now) {
+        deadline = now;
+    }
+
+    // no round until start
+    void stop() {
+        deadline = UINT64_MAX;
+    }
+
+    void round_started(uint64_t now);
+
+    // sets next deadline according to the policy
+    void round_finished(uint64_t started, uint64_t now);
+};
+
+uint64_t monotonic_time_in_microseconds();
+
+#endif //ZADANIE2_TICK_SCHEDULER_H
@@ -0,0 +1,56 @@
+#ifndef ZADANIE2_TIMER_WHEEL_H
+#define ZADANIE2_TIMER_WHEEL_H
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+// Hashed timing wheel: an entry waits in the slot of its deadline and expire() visits only
+// the slots whose time has come. Entries due more than one turn ahead just wait another turn.
+template<typename T>
+class TimerWheel {
+    struct Entry {
+        uint64_t deadline;
+        T value;
+    };
+
+    uint64_t resolution; // time covered by one slot
+    std::vector<std::vector<Entry>> slots;
+    std::vector<Entry> due;
+    uint64_t next_tick; // first slot not visited yet, in units of resolution
+
+public:
+    TimerWheel(uint64_t resolution, size_t slots_count, uint64_t now) :
+            resolution(resolution), slots(slots_count), due(), next_tick(now / resolution) {}
+
+    void schedule(uint64_t deadline, T value) {
+        uint64_t tick = std::max(deadline / resolution, next_tick);
+        slots[tick % slots.size()].push_back({deadline, std::move(value)});
+    }
+
+    // calls on_expired(value) for every entry with deadline <= now, it may schedule new entries
+    template<typename F>
+    void expire(uint64_t now, F on_expired) {
+        uint64_t last_tick = now / resolution;
+        // after a long pause (nobody to time out) one turn visits every slot
+        if (last_tick >= next_tick + slots.size())
+            next_tick = last_tick - slots.size() + 1;
+        for (; next_tick <= last_tick; next_tick++) {
+            auto &slot = slots[next_tick % slots.size()];
+            auto kept = std::partition(slot.begin(), slot.end(),
+                                       [now](const Entry &entry) { return entry.deadline > now; });
+            std::move(kept, slot.end(), std::back_inserter(due));
+            slot.erase(kept, slot.end());
+            // now is somewhere in the last slot, it has to be visited again later
+            if (next_tick == last_tick)
+                break;
+        }
+        for (auto &entry : due)
+            on_expired(entry.value);
+        due.clear();
+    }
+};
+
+#endif //ZADANIE2_TIMER_WHEEL_H
@@ -3,39 +3,78 @@
 #include <sys/socket.h>
 #include <unistd.h>
 #include <cstring>
-#include <thread>
 #include <netinet/in.h>
 #include <algorithm>
-#include <atomic>
-#include <mutex>
 #include <unordered_map>
 #include <netdb.h>
 #include <vector>
 #include <sys/time.h>
 #include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <fcntl.h>
 #include "communication.h"
 #include "err.h"
 #include "crc.h"
+#include "compact_events.h"
+#include "simulation.h"
+#include "snapshot.h"
+#include "gui_output.h"
+#include "reorder_buffer.h"
+#include "tick_scheduler.h"
 
 using namespace std;
 
 #define BUF_SIZE 600
-#define MESSAGE_SERVER_TIME 20000
+#define RECEIVE_BURST 64 // datagrams decoded before what they gave is written to gui
+#define GUI_BACKLOG_LIMIT (1 << 20) // bytes waiting for gui before finished games are dropped from them
+#define MESSAGE_SERVER_TIME 20000 // between heartbeats when nothing happens
+#define MIN_MESSAGE_SERVER_TIME 5000 // between any heartbeats, so that a flood of key presses doesn't flood the server
 
-const char *options = "n:p:i:r:";
+const char *options = "n:p:i:r:cl";
 int sock_serwer, sock_gui;
 string port_serwer = DEFAULT_SERWER_PORT_STR,
         port_gui = DEFAULT_GUI_PORT,
         gui_serwer = DEFAULT_GUI_SERVER,
         player_name = "";
-
-atomic<uint8_t> turn_direction(0);
-atomic<uint32_t> next_expeced_event_no(0);
+bool compact = false; // asks server for compact datagrams
+bool lockstep = false; // asks server for inputs of the rounds, plays the game itself
+
+uint8_t turn_direction(0);
+uint8_t client_flags(0); // sent with heartbeats, lockstep is dropped for the rest of a desynced game
+uint32_t next_expeced_event_no(0);
+uint32_t gap_end(0); // first event kept in early, 0 if none, heartbeats tell the server
+// heartbeat is sent at once (well, as soon as the rate limit allows) when something wants it
+bool heartbeat_now(false);
+uint64_t heartbeat_sent(0);
+string gui_command; // part of the command read so far, without the newline
 int64_t current_game_id = -1;
 vector<string> player_names;
+uint32_t players_count(0); // announced by NEW_GAME, names come in this and following events
+// last pixel of every worm, compact datagrams give steps from it
+struct last_pixel {
+    uint32_t x, y;
+    bool known;
+};
+vector<last_pixel> last_pixels;
 uint32_t maxx(0);
 uint32_t maxy(0);
 uint32_t old_game_id;
+int game_format(0); // marker of the datagrams the current game is read from, 0 for events
+// game played in lockstep mode
+WormTable worms;
+Board board(0, 0);
+uint32_t turning_speed(0);
+uint32_t active_worms(0);
+uint32_t ticks(0);
+bool desynced(false);
+// fragments of the snapshot being collected, it is used once all of them are there
+uint32_t snapshot_event_no(0);
+vector<string> snapshot_fragments;
+vector<bool> snapshot_have;
+uint32_t snapshot_missing(0);
+GuiOutput gui_output; // lines decoded from the datagrams received so far
+ReorderBuffer early; // datagrams waiting for the events before them
 
 void parse_options(int argc, char **argv) {
     int c;
@@ -53,6 +92,12 @@ void parse_options(int argc, char **argv) {
             case 'r':
                 port_gui = optarg;
                 break;
+            case 'c':
+                compact = true;
+                break;
+            case 'l':
+                lockstep = true;
+                break;
             default:
                 fatal("UNKNOWN OPTION");
         }
@@ -110,6 +155,9 @@ void init_gui_conn() {
     if (connect(sock_gui, addr_result->ai_addr, addr_result->ai_addrlen) != 0)
         syserr("connect");
 
+    // a slow gui makes lines wait, never datagrams
+    if (fcntl(sock_gui, F_SETFL, O_NONBLOCK) != 0)
+        syserr("fcntl");
 
     freeaddrinfo(addr_result);
 }
@@ -125,35 +173,55 @@ uint64_t current_time_in_microseconds() {
     return 1000000 * curr_time.tv_sec + curr_time.tv_usec;
 }
 
-//message server and wait for 20ms to pass
-void serwer_message_and_wait(client_to_serwer_mess &message, int32_t size) {
-    uint64_t last_time = current_time_in_microseconds();
+// heartbeat with the name followed by the protocol extension
+union client_message {
+    client_to_serwer_mess message;
+    char bytes[MAX_CLIENT_MESS_LEN];
+};
 
-    message.turn_direction = turn_direction;
-    message.next_expected_event_no = htobe32(next_expeced_event_no);
+uint8_t requested_flags() {
+    return CLIENT_SNAPSHOTS | (compact ? CLIENT_COMPACT : 0) | (lockstep ? CLIENT_LOCKSTEP : 0);
+}
 
-    if (write(sock_serwer, &message, size) < size)
-        syserr("write");
+client_message heartbeat{};
+int32_t heartbeat_size(0);
+
+void init_heartbeat() {
+    heartbeat.message.session_id = htobe64(current_time_in_microseconds());
+    heartbeat_size = CLIENT_HEADER_SIZE;
+    memcpy(heartbeat.bytes + heartbeat_size, player_name.c_str(), player_name.size() + 1);
+    heartbeat_size += player_name.size() + 1;
+    client_extension_mess extension{PROTOCOL_V2, client_flags, 0};
+    memcpy(heartbeat.bytes + heartbeat_size, &extension, sizeof extension);
+    heartbeat_size += sizeof extension;
+}
+
+void send_heartbeat(uint64_t now) {
+    char *extension = heartbeat.bytes + heartbeat_size - sizeof(client_extension_mess);
+    extension[offsetof(client_extension_mess, flags)] = (char) client_flags;
+    uint32_t gap_end_be = htobe32(gap_end);
+    memcpy(extension + offsetof(client_extension_mess, gap_end), &gap_end_be, sizeof gap_end_be);
+    heartbeat.message.turn_direction = turn_direction;
+    heartbeat.message.next_expected_event_no = htobe32(next_expeced_event_no);
 
-    uint64_t time_to_wait = MESSAGE_SERVER_TIME - (current_time_in_microseconds() - last_time);
-    if (time_to_wait > 0)
-        usleep(time_to_wait);
+    if (write(sock_serwer, &heartbeat, heartbeat_size) < heartbeat_size)
+        syserr("write");
+    heartbeat_sent = now;
+    heartbeat_now = false;
 }
 
-//message server in a loop
-[[noreturn]] void send_to_serwer() {
-    uint64_t session_id = current_time_in_microseconds();
-    client_to_serwer_mess my_mess;
-    my_mess.session_id = htobe64(session_id);
-    memcpy(my_mess.player_name, player_name.c_str(), player_name.size());
-    int32_t mess_size = CLIENT_HEADER_SIZE + player_name.size();
+//new direction or a gap server should know about now
+void request_heartbeat() {
+    heartbeat_now = true;
+}
 
-    for (;;) {
-        serwer_message_and_wait(my_mess, mess_size);
-    }
+//at least MIN_MESSAGE_SERVER_TIME and at most MESSAGE_SERVER_TIME after the last one
+uint64_t heartbeat_deadline() {
+    return heartbeat_sent + (heartbeat_now ? MIN_MESSAGE_SERVER_TIME : MESSAGE_SERVER_TIME);
 }
 
 void check_command(const string &command) {
+    uint8_t old_direction = turn_direction;
     if (command == "LEFT_KEY_DOWN")
         turn_direction = LEFT;
     if (command == "RIGHT_KEY_DOWN")
@@ -162,24 +230,32 @@ void check_command(const string &command) {
         turn_direction = 0;
     if (command == "RIGHT_KEY_UP" && turn_direction == RIGHT)
         turn_direction = 0;
+    if (turn_direction != old_direction)
+        request_heartbeat();
 }
 
-[[noreturn]] void listen_to_gui() {
+//takes whatever gui sent, commands are split at newlines, the last one may wait for the rest
+void read_from_gui() {
     char buffer[BUF_SIZE];
-    memset(buffer, 0, BUF_SIZE);
-    string next_comm;
-    for (;;) {
-        int comm_size;
-        if ((comm_size = read(sock_gui, buffer, 100)) < 0)
-            syserr("read");
-        for (int i = 0; i < comm_size; i++) {
-            if (buffer[i] == '\n') {
-                check_command(next_comm);
-                next_comm.clear();
-            } else {
-                next_comm += buffer[i];
-            }
+    ssize_t size = read(sock_gui, buffer, BUF_SIZE);
+    if (size < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return;
+        syserr("read");
+    }
+    if (size == 0)
+        fatal("GUI CLOSED CONNECTION");
+    const char *begin = buffer, *end = buffer + size;
+    while (begin < end) {
+        auto *newline = (const char *) memchr(begin, '\n', end - begin);
+        if (newline == nullptr) {
+            gui_command.append(begin, end);
+            break;
         }
+        gui_command.append(begin, newline);
+        check_command(gui_command);
+        gui_command.clear();
+        begin = newline + 1;
     }
 }
 
@@ -197,6 +273,9 @@ bool chack_and_set_id(int64_t game_id) {
     //got new game, start it
     next_expeced_event_no = 0;
     current_game_id = game_id;
+    client_flags = requested_flags();
+    snapshot_fragments.clear();
+    early.clear();
     return false;
 
 }
@@ -217,95 +296,375 @@ bool bad_crc(char *message, int32_t event_len) {
     return false;
 }
 
-string new_game(char *message, event_header_mess &header) {
-    player_names.clear();
-    char *new_player_names = message + EVENT_HEADER_SIZE + 8;
-
-    maxx = net_buffer_to_32(message + EVENT_HEADER_SIZE);
-    maxy = net_buffer_to_32(message + EVENT_HEADER_SIZE + 4);
-
-    string result = "NEW_GAME " + to_string(maxx) + " " + to_string(maxy);
+//appends names, the game is announced to gui once all of them are known
+void add_player_names(const char *names, uint32_t len) {
     string next_name;
-    for (uint32_t i = 0; i < header.len - NEW_GAME_EVENT_MINIMUMLEN; i++) {
-        if (new_player_names[i]) {
-            next_name += new_player_names[i];
+    for (uint32_t i = 0; i < len; i++) {
+        if (names[i]) {
+            next_name += names[i];
         } else {
-            result += " " + next_name;
             player_names.push_back(next_name);
             next_name.clear();
         }
     }
-    result += "\n";
-    return result;
+    if (player_names.size() > players_count)
+        fatal("TOO MANY PLAYER NAMES");
+    if (player_names.size() < players_count)
+        return;
+    last_pixels.assign(players_count, {0, 0, false});
+
+    gui_output.new_game(maxx, maxy, player_names);
 }
 
-string pixel(char *message, event_header_mess &header) {
-    if (header.len != PIXEL_DATA_LEN)
-        fatal("BAD PIXEL DATA LENGHT");
-    pixel_data_mess data = *(pixel_data_mess *) (message + EVENT_HEADER_SIZE);
-    data.x = be32toh(data.x);
-    data.y = be32toh(data.y);
+void new_game_data(const char *data, uint32_t len) {
+    if (len < sizeof(new_game_data_v2_mess))
+        fatal("BAD NEW GAME DATA LENGHT");
+    player_names.clear();
+    last_pixels.clear();
+
+    maxx = net_buffer_to_32(data);
+    maxy = net_buffer_to_32(data + 4);
+    players_count = net_buffer_to_32(data + 8);
+
+    add_player_names(data + sizeof(new_game_data_v2_mess), len - sizeof(new_game_data_v2_mess));
+}
+
+void new_game(char *message, event_header_mess &header) {
+    if (header.len < NEW_GAME_V2_EVENT_MINIMUMLEN)
+        fatal("BAD NEW GAME DATA LENGHT");
+    new_game_data(message + EVENT_HEADER_SIZE, header.len - EVENT_NO_TYPE_SIZE);
+}
+
+void player_names_event(char *message, event_header_mess &header) {
+    add_player_names(message + EVENT_HEADER_SIZE, header.len - EVENT_NO_TYPE_SIZE);
+}
 
-    if (data.x >= maxx || data.y >= maxy || data.player_number >= player_names.size())
+// only remembers the pixel unless draw
+void pixel_line(uint32_t player_number, uint32_t x, uint32_t y, bool draw = true) {
+    if (x >= maxx || y >= maxy || player_number >= last_pixels.size())
         fatal("PIXEL MAKES NO SENSE");
+    last_pixels[player_number] = {x, y, true};
+
+    if (draw)
+        gui_output.pixel(x, y, player_names[player_number]);
+}
 
-    return "PIXEL " + to_string(data.x) + " " + to_string(data.y)
-           + " " + player_names[data.player_number] + "\n";
+void pixel(char *message, event_header_mess &header) {
+    if (header.len != PIXEL_DATA_V2_LEN)
+        fatal("BAD PIXEL DATA LENGHT");
+    pixel_data_v2_mess data = *(pixel_data_v2_mess *) (message + EVENT_HEADER_SIZE);
 
+    pixel_line(be16toh(data.player_number), be32toh(data.x), be32toh(data.y));
 }
 
-string eliminated(char *message, event_header_mess &header) {
-    if (header.len != ELIMINATED_DATA_LEN)
-        fatal("BAD ELIMINATED DATA LENGHT");
-    eliminated_data_mess data = *(eliminated_data_mess *) (message + EVENT_HEADER_SIZE);
-    if (data.player_number >= player_names.size())
+void eliminated_line(uint32_t player_number) {
+    if (player_number >= player_names.size())
         fatal("ELIMINATED MAKES NO SENSE");
 
-    return "PLAYER_ELIMINATED " + player_names[data.player_number] + "\n";
+    gui_output.eliminated(player_names[player_number]);
 }
 
-string end_game(char *, event_header_mess &header) {
-    if (header.len != END_GAME_DATA_LEN)
-        fatal("BAD END DATA LENGHT");
+void eliminated(char *message, event_header_mess &header) {
+    if (header.len != ELIMINATED_DATA_V2_LEN)
+        fatal("BAD ELIMINATED DATA LENGHT");
+    eliminated_data_v2_mess data = *(eliminated_data_v2_mess *) (message + EVENT_HEADER_SIZE);
 
+    eliminated_line(be16toh(data.player_number));
+}
+
+void end_game_line() {
     old_game_id = current_game_id;
     current_game_id = -1;
+    client_flags = requested_flags();
+}
+
+void end_game(char *, event_header_mess &header) {
+    if (header.len != END_GAME_DATA_LEN)
+        fatal("BAD END DATA LENGHT");
+
+    end_game_line();
+}
+
+void read_number(const uint8_t *&record, const uint8_t *end, uint32_t &value) {
+    if (!read_varint(record, end, value))
+        fatal("BAD COMPACT RECORD");
+}
+
+//draws the whole snapshot, then events continue after it
+void apply_snapshot() {
+    string bytes;
+    for (auto &fragment : snapshot_fragments)
+        bytes += fragment;
+    snapshot_fragments.clear();
+    const auto *next = (const uint8_t *) bytes.data(), *end = next + bytes.size();
+
+    uint32_t count, player_number, x, y, skipped, len;
+    vector<uint32_t> eliminated_players;
+    read_number(next, end, count);
+    for (uint32_t i = 0; i < count; i++) {
+        read_number(next, end, player_number);
+        eliminated_players.push_back(player_number);
+    }
+    vector<pair<uint32_t, last_pixel>> heads;
+    read_number(next, end, count);
+    for (uint32_t i = 0; i < count; i++) {
+        read_number(next, end, player_number);
+        read_number(next, end, x);
+        read_number(next, end, y);
+        heads.push_back({player_number, {x, y, true}});
+    }
 
+    uint64_t pixel = 0;
+    while (next < end) {
+        read_number(next, end, skipped);
+        read_number(next, end, len);
+        read_number(next, end, player_number);
+        pixel += skipped;
+        if (pixel + len > (uint64_t) maxx * maxy)
+            fatal("SNAPSHOT MAKES NO SENSE");
+        for (uint32_t i = 0; i < len; i++, pixel++)
+            pixel_line(player_number, pixel % maxx, pixel / maxx);
+    }
+    for (auto &head : heads)
+        pixel_line(head.first, head.second.x, head.second.y, false);
+    for (uint32_t player : eliminated_players)
+        eliminated_line(player);
+    next_expeced_event_no = snapshot_event_no;
+}
 
-    return "";
+//collects fragments of a snapshot newer than what the client knows, but only once the names are known
+void snapshot_fragment(char *message, event_header_mess &header) {
+    if (header.len < EVENT_NO_TYPE_SIZE + sizeof(snapshot_data_mess))
+        fatal("BAD SNAPSHOT DATA LENGHT");
+    snapshot_data_mess data = *(snapshot_data_mess *) (message + EVENT_HEADER_SIZE);
+    uint32_t fragment_no = be32toh(data.fragment_no), count = be32toh(data.fragments_count);
+    if (fragment_no >= count || count > UINT32_MAX / SNAPSHOT_FRAGMENT_LEN)
+        fatal("SNAPSHOT MAKES NO SENSE");
+    if (next_expeced_event_no == 0 || last_pixels.size() != players_count ||
+        header.event_no <= next_expeced_event_no)
+        return;
+
+    if (snapshot_fragments.empty() || header.event_no != snapshot_event_no || count != snapshot_fragments.size()) {
+        snapshot_event_no = header.event_no;
+        snapshot_fragments.assign(count, "");
+        snapshot_have.assign(count, false);
+        snapshot_missing = count;
+    }
+    if (!snapshot_have[fragment_no]) {
+        snapshot_have[fragment_no] = true;
+        snapshot_missing--;
+        snapshot_fragments[fragment_no].assign(message + EVENT_HEADER_SIZE + sizeof data,
+                                               header.len - EVENT_NO_TYPE_SIZE - sizeof data);
+    }
+    if (snapshot_missing == 0)
+        apply_snapshot();
 }
 
-string parse_event(char *message, event_header_mess &header) {
+void parse_event(char *message, event_header_mess &header) {
+    if (header.event_type == SNAPSHOT_TYPE) {
+        snapshot_fragment(message, header);
+        return;
+    }
     if (next_expeced_event_no != header.event_no)
-        return "";
+        return;
     next_expeced_event_no++;
     switch (header.event_type) {
         case NEW_GAME_TYPE:
-            return new_game(message, header);
+            new_game(message, header);
+            break;
         case PIXEL_TYPE:
-            return pixel(message, header);
+            pixel(message, header);
+            break;
         case ELIMINATED_TYPE:
-            return eliminated(message, header);
+            eliminated(message, header);
+            break;
         case END_GAME_TYPE:
-            return end_game(message, header);
+            end_game(message, header);
+            break;
+        case PLAYER_NAMES_TYPE:
+            player_names_event(message, header);
+            break;
         default:
             //ignoring
-            return "";
+            break;
     }
 }
-//parses one message from server to string
-string parse_message(char *message, int32_t size) {
-    string result = "";
-    if (size < 4)
-        return "";
-    uint32_t game_id = net_buffer_to_32(message);
-    message += 4;
-    size -= 4;
 
-    if (chack_and_set_id(game_id)) {
-        return result;
+
+//parses one record of a compact datagram, it is applied only if it is the expected event
+void parse_record(const uint8_t *&record, const uint8_t *end, bool expected) {
+    uint8_t tag = *record++;
+    uint32_t player_number, x, y, len;
+    if (COMPACT_PIXEL_STEP <= tag && tag < COMPACT_PIXEL_STEP + 9) {
+        read_number(record, end, player_number);
+        if (!expected)
+            return;
+        if (player_number >= last_pixels.size() || !last_pixels[player_number].known)
+            fatal("PIXEL MAKES NO SENSE");
+        int32_t dx = (tag - COMPACT_PIXEL_STEP) / 3 - 1, dy = (tag - COMPACT_PIXEL_STEP) % 3 - 1;
+        pixel_line(player_number, last_pixels[player_number].x + dx, last_pixels[player_number].y + dy);
+        return;
+    }
+    switch (tag) {
+        case NEW_GAME_TYPE:
+        case PLAYER_NAMES_TYPE: {
+            read_number(record, end, len);
+            if (len > (uint32_t) (end - record))
+                fatal("BAD COMPACT RECORD");
+            const char *data = (const char *) record;
+            record += len;
+            if (!expected)
+                return;
+            if (tag == NEW_GAME_TYPE)
+                new_game_data(data, len);
+            else
+                add_player_names(data, len);
+            return;
+        }
+        case PIXEL_TYPE:
+            read_number(record, end, player_number);
+            read_number(record, end, x);
+            read_number(record, end, y);
+            if (expected)
+                pixel_line(player_number, x, y);
+            return;
+        case ELIMINATED_TYPE:
+            read_number(record, end, player_number);
+            if (expected)
+                eliminated_line(player_number);
+            return;
+        case END_GAME_TYPE:
+            if (expected)
+                end_game_line();
+            return;
+        default:
+            // length of unknown records is unknown too
+            fatal("BAD COMPACT RECORD");
+    }
+}
+
+void start_lockstep() {
+    worms.clear();
+    board = Board(maxx, maxy);
+    active_worms = 0;
+    ticks = 0;
+}
+
+//parses one record of a lockstep datagram, pixels and eliminations come from playing the game
+void parse_lockstep_record(const uint8_t *&record, const uint8_t *end, bool expected) {
+    uint8_t tag = *record;
+    if (tag < LOCKSTEP_RULES) {
+        // shared with compact datagrams
+        parse_record(record, end, expected);
+        if (tag == NEW_GAME_TYPE && expected)
+            start_lockstep();
+        return;
+    }
+    record++;
+
+    auto on_pixel = [](uint32_t x, uint32_t y, uint32_t player_no) {
+        pixel_line(player_no, x, y);
+    };
+    auto on_eliminated = [](uint32_t player_no) {
+        eliminated_line(player_no);
+    };
+    uint32_t x, y, direction, len, hash_ticks;
+    switch (tag) {
+        case LOCKSTEP_RULES:
+            read_number(record, end, len);
+            if (expected) {
+                if (len == 0 || MAX_TURNING_SPEED < len)
+                    fatal("RULES MAKE NO SENSE");
+                turning_speed = len;
+            }
+            return;
+        case LOCKSTEP_WORM:
+            read_number(record, end, x);
+            read_number(record, end, y);
+            read_number(record, end, direction);
+            if (!expected)
+                return;
+            if (worms.size() >= last_pixels.size() || x >= maxx || y >= maxy || direction >= 360)
+                fatal("WORM MAKES NO SENSE");
+            place_worm(worms, board, x, y, direction, 0, active_worms, on_pixel, on_eliminated);
+            return;
+        case LOCKSTEP_TICK: {
+            read_number(record, end, len);
+            if (len > (uint32_t) (end - record))
+                fatal("BAD COMPACT RECORD");
+            const uint8_t *inputs = record;
+            record += len;
+            if (!expected)
+                return;
+            if (worms.size() != last_pixels.size() || len != (worms.size() + 3) / 4 || game_over(active_worms))
+                fatal("TICK MAKES NO SENSE");
+            for (uint32_t i = 0; i < worms.size(); i++) {
+                worms.turn_direction[i] = (inputs[i / 4] >> (2 * (i % 4))) & 3;
+                if (worms.turn_direction[i] > LEFT)
+                    fatal("TICK MAKES NO SENSE");
+            }
+            play_round(worms, board, turning_speed, active_worms, on_pixel, on_eliminated);
+            ticks++;
+            return;
+        }
+        case LOCKSTEP_HASH: {
+            read_number(record, end, hash_ticks);
+            if (end - record < (int64_t) sizeof(uint32_t))
+                fatal("BAD COMPACT RECORD");
+            uint32_t hash = net_buffer_to_32((const char *) record);
+            record += sizeof hash;
+            if (expected && (hash_ticks != ticks || hash != state_hash(worms)))
+                desynced = true;
+            return;
+        }
+        default:
+            fatal("BAD COMPACT RECORD");
+    }
+}
+
+//game is read again from its first event, this time without lockstep
+void leave_lockstep() {
+    desynced = false;
+    client_flags = requested_flags() & ~CLIENT_LOCKSTEP;
+    next_expeced_event_no = 0;
+    early.clear();
+}
+
+//parses compact or lockstep datagram (after game id), its events are numbered from the one in the header
+void parse_compact(const uint8_t *message, int32_t size) {
+    compact_header_mess header = *(compact_header_mess *) message;
+    size -= sizeof(crc32_t);
+    if (crc_finish(crc_update(crc_start(), message, size)) != net_buffer_to_32((const char *) message + size))
+        return;
+
+    uint32_t event_no = be32toh(header.first_event_no);
+    const uint8_t *record = message + sizeof header, *end = message + size;
+    while (record < end) {
+        bool expected = event_no == next_expeced_event_no;
+        if (header.marker == LOCKSTEP_MARKER)
+            parse_lockstep_record(record, end, expected);
+        else
+            parse_record(record, end, expected);
+        if (desynced) {
+            leave_lockstep();
+            return;
+        }
+        if (expected)
+            next_expeced_event_no++;
+        event_no++;
     }
+}
+
+//marker of compact and lockstep datagrams, events start with their length, which can't begin with it
+int datagram_format(const char *message, int32_t size) {
+    if (size < (int32_t) (sizeof(compact_header_mess) + sizeof(crc32_t)))
+        return 0;
+    uint8_t marker = message[0];
+    return marker == COMPACT_MARKER || marker == LOCKSTEP_MARKER ? marker : 0;
+}
 
+//parses events of a datagram (after game id)
+void parse_events(char *message, int32_t size) {
     while (size >= EVENT_HEADER_META) {
         event_header_mess next_event = get_next_event(message);
 
@@ -313,45 +672,185 @@ string parse_message(char *message, int32_t size) {
             break;
         }
 
-        result += parse_event(message, next_event);
+        parse_event(message, next_event);
         message += (next_event.len - EVENT_NO_TYPE_SIZE + EVENT_HEADER_META);
         size -= (next_event.len - EVENT_NO_TYPE_SIZE + EVENT_HEADER_META);
     }
-    return result;
 }
 
-[[noreturn]] void receive_and_send() {
+bool snapshot_datagram(char *message, int32_t size) {
+    return size >= EVENT_HEADER_META && get_next_event(message).event_type == SNAPSHOT_TYPE;
+}
+
+//first event of a datagram (after game id) of the format
+uint32_t first_event_no(const char *message, int32_t size, int format) {
+    if (format != 0)
+        return be32toh(((const compact_header_mess *) message)->first_event_no);
+    return size >= EVENT_HEADER_META ? get_next_event((char *) message).event_no : 0;
+}
+
+//parses one message from server, lines for gui go to gui_output,
+//datagram which starts after the expected event is kept until the events before it arrive
+void parse_message(char *message, int32_t size) {
+    char *datagram = message;
+    int32_t datagram_size = size;
+    if (size < 4)
+        return;
+    uint32_t game_id = net_buffer_to_32(message);
+    message += 4;
+    size -= 4;
+
+    if (chack_and_set_id(game_id))
+        return;
+
+    int format = datagram_format(message, size);
+    if (format == LOCKSTEP_MARKER && !(client_flags & CLIENT_LOCKSTEP))
+        return;
+    // snapshots come in events whatever the format
+    if (format == 0 && snapshot_datagram(message, size)) {
+        parse_events(message, size);
+        return;
+    }
+    // the server may switch formats (after a desync or when lockstep can't describe the game),
+    // then the game is read again from its first event
+    if (next_expeced_event_no == 0)
+        game_format = format;
+    else if (format != game_format)
+        return;
+    if (first_event_no(message, size, format) > next_expeced_event_no) {
+        early.keep(first_event_no(message, size, format), datagram, datagram_size);
+        return;
+    }
+    if (format != 0)
+        parse_compact((uint8_t *) message, size);
+    else
+        parse_events(message, size);
+}
+
+//writes as much as gui takes now, true if nothing is left waiting
+bool flush_to_gui() {
+    while (gui_output.size() > 0) {
+        ssize_t written = write(sock_gui, gui_output.data(), gui_output.size());
+        if (written < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return false;
+            syserr("write");
+        }
+        gui_output.consume(written);
+    }
+    return true;
+}
+
+//takes what came (up to a burst), gui gets lines of all of it with one write when it can take them
+void receive_from_serwer() {
     char buffer[BUF_SIZE];
-    int read_size;
-    for (;;) {
-        if ((read_size = read(sock_serwer, buffer, BUF_SIZE)) < 0)
+    for (int i = 0; i < RECEIVE_BURST; i++) {
+        ssize_t read_size = recv(sock_serwer, buffer, BUF_SIZE, MSG_DONTWAIT);
+        if (read_size < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
             syserr("read");
+        }
         if (read_size > MAX_HOST_MESS_LEN)
             fatal("MESSAGE FROM SERWER TOO LONG");
+        parse_message(buffer, read_size);
+        while ((read_size = early.take(next_expeced_event_no, buffer)) >= 0)
+            parse_message(buffer, read_size);
+    }
+    // a new gap asks for the events missing in it
+    uint32_t new_gap_end = early.gap_end();
+    if (new_gap_end != gap_end && new_gap_end != 0)
+        request_heartbeat();
+    gap_end = new_gap_end;
+    // gui that doesn't keep up skips to the last game it was sent
+    if (gui_output.size() > GUI_BACKLOG_LIMIT)
+        gui_output.skip_finished_games();
+}
 
-        string to_send = parse_message(buffer, read_size);
+enum source {
+    SERWER, GUI, HEARTBEAT_TIMER
+};
+
+// One thread waiting on both sockets and a timer for the next heartbeat, so key presses and
+// gaps move the heartbeat closer without any locking, and nothing wakes up when nothing happens.
+// Lines gui doesn't take at once wait until epoll says it can take more, datagrams are read meanwhile.
+[[noreturn]] void play() {
+    int epoll_fd = epoll_create1(0);
+    if (epoll_fd < 0)
+        syserr("epoll_create1");
+    int timer_fd = timerfd_create(CLOCK_MONOTONIC, 0);
+    if (timer_fd < 0)
+        syserr("timerfd_create");
+    // epoll data is the source
+    int fds[] = {sock_serwer, sock_gui, timer_fd};
+    for (uint32_t i = SERWER; i <= HEARTBEAT_TIMER; i++) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u32 = i;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fds[i], &event) < 0)
+            syserr("epoll_ctl");
+    }
 
-        if (to_send.empty())
-            continue;
+    init_heartbeat();
+    uint64_t armed = 0;
+    bool gui_blocked = false; // epoll waits for gui to take more
+    epoll_event events[3];
+    for (;;) {
+        uint64_t now = monotonic_time_in_microseconds();
+        if (now >= heartbeat_deadline())
+            send_heartbeat(now);
+
+        // absolute time, only set again when the deadline moved
+        uint64_t wake_up = heartbeat_deadline();
+        if (wake_up != armed) {
+            itimerspec timer{};
+            timer.it_value.tv_sec = wake_up / 1000000;
+            timer.it_value.tv_nsec = (wake_up % 1000000) * 1000;
+            if (timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &timer, nullptr) < 0)
+                syserr("timerfd_settime");
+            armed = wake_up;
+        }
 
-        if (write(sock_gui, to_send.c_str(), to_send.size()) < (ssize_t) to_send.size())
-            syserr("write");
+        int ready = epoll_wait(epoll_fd, events, 3, -1);
+        if (ready < 0 && errno != EINTR)
+            syserr("epoll_wait");
+        bool gui_writable = !gui_blocked;
+        for (int i = 0; i < ready; i++) {
+            if (events[i].data.u32 == SERWER) {
+                receive_from_serwer();
+            } else if (events[i].data.u32 == GUI) {
+                if (events[i].events & ~EPOLLOUT)
+                    read_from_gui();
+                if (events[i].events & EPOLLOUT)
+                    gui_writable = true;
+            } else {
+                uint64_t expirations;
+                if (read(timer_fd, &expirations, sizeof expirations) < 0 && errno != EAGAIN)
+                    syserr("read");
+            }
+        }
 
+        if (gui_writable) {
+            bool blocked = !flush_to_gui();
+            if (blocked != gui_blocked) {
+                gui_blocked = blocked;
+                epoll_event event{};
+                event.events = gui_blocked ? EPOLLIN | EPOLLOUT : EPOLLIN;
+                event.data.u32 = GUI;
+                if (epoll_ctl(epoll_fd, EPOLL_CTL_MOD, sock_gui, &event) < 0)
+                    syserr("epoll_ctl");
+            }
+        }
     }
 }
 
-void play() {
-    thread sender(send_to_serwer);
-    thread from_server_to_gui(receive_and_send);
-    listen_to_gui();
-}
-
 int main(int argc, char **argv) {
     if (argc < 2)
         fatal("No serwer adress provided");
 
     string serwer_name = argv[1];
     parse_options(argc, argv);
+    client_flags = requested_flags();
     if (player_name.size() > 20)
         fatal("name too long");
     init_connections(serwer_name);
@@ -1,304 +1,298 @@
 #include <iostream>
 #include <cstdint>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <cassert>
 #include <cstdlib>
 #include <cstring>
 #include <thread>
 #include <chrono>
-#include <sys/time.h>
 #include <netinet/in.h>
+#include <linux/filter.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+#include <pthread.h>
 #include <vector>
+#include <array>
 #include <algorithm>
-#include <cmath>
+#include <atomic>
 #include <mutex>
-#include <condition_variable>
+#include <memory>
+#include <string_view>
+#include <random>
+#include <unordered_set>
 #include <unordered_map>
 #include <utility>
 #include "communication.h"
 #include "err.h"
 #include "crc.h"
+#include "board.h"
+#include "event_log.h"
+#include "tick_scheduler.h"
+#include "timer_wheel.h"
+#include "connection_table.h"
+#include "simulation.h"
+#include "compact_events.h"
+#include "snapshot.h"
+#include "send_window.h"
 
 #define RANDOM_MULT 279410273
 #define RANDOM_MOD 4294967291
 
-#define MAX_CONNECTED 25
+#define MAX_CONNECTED 25 // default players per room
 #define MAX_IDLE_TIME 2000000
+#define IDLE_WHEEL_RESOLUTION 100000
+#define IDLE_WHEEL_SLOTS 32
+#define MAX_ROOMS 1024
+#define MAX_SHARDS 64 // receiving sockets of a room
+#define RECEIVE_BATCH 64
+#define PROTOCOLS 2
+#define LOCKSTEP_HASH_INTERVAL 50 // ticks between state hashes in the lockstep stream
+#define DEFAULT_LOG_MEMORY 32 // MiB, older blocks of a log spill to a temporary file
+#define MAX_LOG_MEMORY (1024 * 1024)
+#define SNAPSHOT_MIN_EVENTS 1024 // v2 events after the latest snapshot before a new one is worth taking
+
+// longest names part of events which are sent alone in a datagram
+#define NEW_GAME_NAMES_LEN (MAX_HOST_MESS_LEN - sizeof(uint32_t) - EVENT_HEADER_META - sizeof(new_game_data_mess))
+#define NEW_GAME_V2_NAMES_LEN (MAX_HOST_MESS_LEN - sizeof(uint32_t) - EVENT_HEADER_META - sizeof(new_game_data_v2_mess))
+#define PLAYER_NAMES_LEN (MAX_HOST_MESS_LEN - sizeof(uint32_t) - EVENT_HEADER_META)
 
 using namespace std;
 
 
 /* globals */
 
-uint8_t connected_players = 0;
-uint8_t ready_players = 0;
-int sock_fd = 0;
-
-const char *options = "p:s:t:v:w:h:";
-
-constexpr double DEG_TO_RADIANS = M_PI / 180.0;
+const char *options = "p:s:t:v:w:h:r:c:l:a:n:m:i:g:e";
 
 uint64_t turning_speed = DEFAULT_TURNING_SPEED;
 uint64_t rounds_per_second = DEFAULT_ROUNDS_PER_SECOND;
 uint16_t port = DEFAULT_SERWER_PORT;
 uint64_t maxx = DEFAULT_WIDTH;
 uint64_t maxy = DEFAULT_HEIGHT;
-
-mutex mut{};
-mutex wait_for_players_mut{};
-condition_variable wait_for_players{};
-
+uint64_t rooms_count = 1;
+uint64_t workers_count = 0; // 0 -> one worker per core (but not more than rooms)
+uint64_t report_interval = 0; // seconds between counter reports on stderr, 0 -> no reports
+CatchUp catch_up = CatchUp::BURST; // late rounds run back to back, with -a skip they are dropped
+uint64_t shards_count = 1; // sockets (SO_REUSEPORT) of every room, with more than one each has a thread
+bool reactor = false; // one unpinned thread runs all rooms, see do_reactor
+bool steer_by_cpu = false; // shard is chosen by the cpu which got the datagram, not by the client's address
+uint64_t max_players = MAX_CONNECTED; // connections per room
+uint64_t log_memory = DEFAULT_LOG_MEMORY; // MiB of each game log (with its index) kept in memory, 0 -> no limit
+
+// monotonic, so that wall clock jumps don't disturb rounds nor idle timeouts
 uint64_t current_time_in_microseconds() {
-    timeval curr_time{};
-    gettimeofday(&curr_time, nullptr);
-    return 1000000 * curr_time.tv_sec + curr_time.tv_usec;
+    return monotonic_time_in_microseconds();
 }
 
+// players of one room, kept up to date by PlayerSlab
+struct PlayerCounters {
+    uint32_t connected_players = 0;
+    uint32_t ready_players = 0;
+};
+
 struct PlayerData {
 
-    uint64_t last_connected, session_id;
-    long double x, y;
-    int32_t direction;
-    bool ready_to_play, eliminated;
+    sockaddr_in6 address; // of its connection, while connected
+    uint32_t connected_at; // position in the slab's connected slots, while connected
+    uint32_t player_no; // in the current game, while in_game
+    uint8_t protocol_version;
+    uint8_t flags; // CLIENT_ flags of the last heartbeat, which datagrams it gets
+    bool ready_to_play;
     uint8_t turn_direction;
     string name;
-
-    PlayerData(uint64_t session_id, uint8_t turn_direction, const string &name) :
-            last_connected(current_time_in_microseconds()), session_id(session_id),
-            x(0), y(0), direction(0),
-            ready_to_play(false), eliminated(false),
-            turn_direction(turn_direction),
-            name(name) {
-        if (!name.empty())
-            connected_players++;
-        set_direction(turn_direction);
-    }
-
-    ~PlayerData() {
-        if (ready_to_play)
-            ready_players--;
-        if (!name.empty())
-            connected_players--;
-    }
+    bool connected, in_game; // slot is free when neither
+    SendWindow window; // of the stream it gets
+    Pacer pacer;
 
     bool operator<(const PlayerData &p2) const {
         return name < p2.name;
     }
 
-    void set_direction(uint8_t new_turn_direction) {
-        turn_direction = new_turn_direction;
-        if (!ready_to_play && turn_direction != 0 && !name.empty()) {
-            ready_to_play = true;
-            ready_players++;
-        }
-    }
-
-    void game_ended() {
-        eliminated = false;
-        if (ready_to_play) {
-            ready_to_play = false;
-            ready_players--;
-        }
-    }
-
-};
-
-struct PlayerWrapper {
-    shared_ptr<PlayerData> data;
-
-    PlayerWrapper(uint64_t session_id, uint8_t turn_direction, const string &name) :
-            data(make_shared<PlayerData>(session_id, turn_direction, name)) {}
-
-    PlayerData &operator*() {
-        return *data;
-    }
-
-    bool operator<(const PlayerWrapper &p2) const {
-        return *data < *p2.data;
-    }
-
-    PlayerData *operator->() {
-        return data.operator->();
-    }
 };
 
-struct Event {
-    event_header_mess header;
-    string data;
-    crc32_t checksum;
+// Players of a room in slots allocated up front. A slot is taken by a connection and stays
+// taken while its player is in the current game, even if the connection is already gone.
+class PlayerSlab {
+    vector<PlayerData> slots;
+    vector<uint32_t> free_slots;
+    vector<uint32_t> connected_slots;
 
-    Event(const string &data, uint32_t event_no, uint8_t type) :
-            header(htobe32(data.size() + EVENT_NO_TYPE_SIZE),
-                   htobe32(event_no), type), data(data), checksum(calc_checksum()) {}
-
-    crc32_t calc_checksum() {
-        uint8_t mess[MAX_HOST_MESS_LEN];
-        memcpy(mess, &header, EVENT_HEADER_SIZE);
-        memcpy(mess + EVENT_HEADER_SIZE, data.c_str(), data.size());
-        return htobe32(crc_cacl(mess, EVENT_HEADER_SIZE + data.size()));
+    void release_if_unused(uint32_t slot) {
+        auto &p = slots[slot];
+        if (p.connected || p.in_game)
+            return;
+        if (p.ready_to_play)
+            counters.ready_players--;
+        if (!p.name.empty())
+            counters.connected_players--;
+        free_slots.push_back(slot);
     }
 
-    [[nodiscard]] ssize_t size() const {
-        return data.size() + EVENT_HEADER_META;
-    }
-};
+public:
+    PlayerCounters counters{};
 
-struct GameData {
-    uint32_t game_id;
-    vector<PlayerWrapper> players;
-    vector<Event> events;
-    uint32_t active_players;
-    bool board[MAX_WIDTH][MAX_HEIGHT]; // board[i][j] -> is space (i, j) eaten/being eaten
-
-    GameData() : game_id(), players(), events(), active_players(), board() {
-        for (auto &i : board)
-            memset(i, false, MAX_HEIGHT);
-    }
-
-    void clear() {
-        players.clear();
-        events.clear();
-        game_id = 0;
-        active_players = 0;
-        for (auto &i : board)
-            memset(i, false, MAX_HEIGHT);
-    }
-
-    void end_game() {
-        for (auto &p : players) {
-            p->game_ended();
+    explicit PlayerSlab(uint32_t size) : slots(size), free_slots(), connected_slots() {
+        for (uint32_t i = size; i > 0; i--) {
+            slots[i - 1].name.reserve(MAX_PLAYER_NAME_LENGTH);
+            free_slots.push_back(i - 1);
         }
-        players.clear();
+        connected_slots.reserve(size);
     }
-} current_game{};
-
-struct AddressBase {
-    virtual ~AddressBase() = default;
-
-    virtual sockaddr *get_address() = 0;
-
-    virtual bool operator==(const AddressBase &a) const = 0;
 
-    virtual socklen_t size() = 0;
-
-    [[nodiscard]] virtual size_t hash() const = 0;
-};
-
-struct AddressIP4 : public AddressBase {
-    sockaddr_in address;
-    socklen_t addr_size;
-
-    explicit AddressIP4(const sockaddr_in *address) : address(*address), addr_size(sizeof(sockaddr_in)) {
+    PlayerData &operator[](uint32_t slot) {
+        return slots[slot];
     }
 
-    bool operator==(const AddressBase &a) const override {
-        if (const auto *ptr = dynamic_cast<const AddressIP4 *>(&a))
-            return address.sin_port == ptr->address.sin_port &&
-                   address.sin_addr.s_addr == ptr->address.sin_addr.s_addr;
-        return false;
+    // slots of the players with a connection, in no particular order
+    [[nodiscard]] const vector<uint32_t> &connected() const {
+        return connected_slots;
     }
 
-    sockaddr *get_address() override {
-        return reinterpret_cast<sockaddr *>(&address);
-    }
-
-    socklen_t size() override {
-        return addr_size;
-    }
-
-    [[nodiscard]] size_t hash() const override {
-        return address.sin_addr.s_addr + address.sin_port;
-    }
-};
-
-struct AddressIP6 : public AddressBase {
-    sockaddr_in6 address;
-    socklen_t addr_size;
-
-    explicit AddressIP6(const sockaddr_in6 *address) : address(*address), addr_size(sizeof(sockaddr_in6)) {
-
+    // there is always a free slot for every connection
+    uint32_t take(const sockaddr_in6 &address, uint8_t turn_direction, const string_view &name,
+                  uint8_t protocol_version, uint8_t flags, uint64_t now) {
+        uint32_t slot = free_slots.back();
+        free_slots.pop_back();
+        auto &p = slots[slot];
+        p.address = address;
+        p.connected_at = connected_slots.size();
+        connected_slots.push_back(slot);
+        p.player_no = 0;
+        p.protocol_version = protocol_version;
+        p.flags = flags;
+        p.ready_to_play = false;
+        p.name.assign(name);
+        p.connected = true;
+        p.in_game = false;
+        p.window = SendWindow();
+        p.pacer.reset(now);
+        if (!p.name.empty())
+            counters.connected_players++;
+        set_direction(slot, turn_direction);
+        return slot;
     }
 
-    bool operator==(const AddressBase &a) const override {
-        if (const auto *ptr = dynamic_cast<const AddressIP6 *>(&a)) {
-            return address.sin6_port == ptr->address.sin6_port &&
-                   !memcmp(address.sin6_addr.s6_addr, ptr->address.sin6_addr.s6_addr,
-                           sizeof(address.sin6_addr.s6_addr));
+    void set_direction(uint32_t slot, uint8_t new_turn_direction) {
+        auto &p = slots[slot];
+        p.turn_direction = new_turn_direction;
+        if (!p.ready_to_play && p.turn_direction != 0 && !p.name.empty()) {
+            p.ready_to_play = true;
+            counters.ready_players++;
         }
-        return false;
     }
 
-    sockaddr *get_address() override {
-        return reinterpret_cast<sockaddr *>(&address);
+    void join_game(uint32_t slot) {
+        slots[slot].in_game = true;
     }
 
-    socklen_t size() override {
-        return addr_size;
+    void game_ended(uint32_t slot) {
+        auto &p = slots[slot];
+        if (p.ready_to_play) {
+            p.ready_to_play = false;
+            counters.ready_players--;
+        }
+        p.in_game = false;
+        release_if_unused(slot);
     }
 
-    [[nodiscard]] size_t hash() const override {
-        return address.sin6_addr.s6_addr[0] + address.sin6_port;
+    void disconnected(uint32_t slot) {
+        auto &p = slots[slot];
+        uint32_t last = connected_slots.back();
+        connected_slots[p.connected_at] = last;
+        slots[last].connected_at = p.connected_at;
+        connected_slots.pop_back();
+        p.connected = false;
+        release_if_unused(slot);
     }
 };
 
-struct AddressWrapper {
-    shared_ptr<AddressBase> address;
-
-    explicit AddressWrapper(const sockaddr_in *addr) : address(make_shared<AddressIP4>(addr)) {}
+// events of a game encoded for one protocol version
+struct EventStream {
+    EventLog events;
+    DatagramCache<EventSlice> datagrams;
+    bool kept = false; // v1 can't describe games with too many players, nobody gets such stream
 
-    explicit AddressWrapper(const sockaddr_in6 *addr) : address(make_shared<AddressIP6>(addr)) {}
-
-    AddressBase &operator*() {
-        return *address;
+    void clear() {
+        datagrams.clear();
+        events.clear();
+        kept = false;
     }
+};
 
-    bool operator==(const AddressWrapper &a) const {
-        return *address == *(a.address);
-    }
+// where a batch of new events starts in every stream
+struct StreamSizes {
+    array<uint32_t, PROTOCOLS> events;
+    uint32_t lockstep;
+};
 
-    [[nodiscard]] sockaddr *get_address() const {
-        return address->get_address();
-    }
+struct GameData {
+    uint32_t game_id;
+    vector<uint32_t> players; // slots, sorted by name
+    WormTable worms; // hot state of the players, in the same order
+    EventStream streams[PROTOCOLS]; // by protocol version - 1, v1 is made from v2 once it is read
+    CompactStream compact; // v2 events, encoded compactly once they are read
+    LockstepStream lockstep; // inputs of the rounds, for clients which play the game themselves
+    Snapshot snapshot; // for v2 clients catching up
+    uint32_t names_events; // v2 events with the names, they come before the snapshot
+    uint32_t v1_made_until, compact_made_until; // v2 events already put in those streams
+    uint32_t active_players;
+    uint32_t ticks; // rounds played
+    Board board; // is space (x, y) eaten/being eaten
 
-    [[nodiscard]] socklen_t size() const {
-        return address->size();
+    GameData() : game_id(), players(), worms(), streams(), compact(), lockstep(), snapshot(), names_events(),
+                 v1_made_until(), compact_made_until(), active_players(), ticks(), board(maxx, maxy) {
+        players.reserve(max_players);
+        worms.reserve(max_players);
     }
 
-    static AddressWrapper makeAddressWrapper(const sockaddr *addr) {
-        if (addr->sa_family == AF_INET)
-            return AddressWrapper((sockaddr_in *) addr);
-        return AddressWrapper((sockaddr_in6 *) addr);
+    EventStream &stream(uint8_t protocol_version) {
+        return streams[protocol_version - 1];
     }
 
-    [[nodiscard]] size_t hash() const {
-        return address->hash();
+    StreamSizes events_count() const {
+        StreamSizes count{};
+        for (int i = 0; i < PROTOCOLS; i++)
+            count.events[i] = streams[i].events.size();
+        count.lockstep = lockstep.size();
+        return count;
     }
 
-    AddressBase *operator->() {
-        return address.operator->();
+    void clear() {
+        players.clear();
+        worms.clear();
+        for (auto &stream : streams)
+            stream.clear();
+        compact.clear();
+        lockstep.clear();
+        snapshot.clear(maxx);
+        names_events = 0;
+        v1_made_until = 0;
+        compact_made_until = 0;
+        game_id = 0;
+        active_players = 0;
+        ticks = 0;
+        board.clear();
     }
 
-};
-
-template<>
-struct std::hash<AddressWrapper> {
-    std::size_t operator()(const AddressWrapper &a) const {
-        return a.hash();
+    void end_game(PlayerSlab &slab) {
+        for (auto p : players) {
+            slab.game_ended(p);
+        }
+        players.clear();
     }
 };
 
-unordered_map<AddressWrapper, PlayerWrapper> connections{};
-
 /* Random */
 
 uint64_t random_value = time(nullptr);
 
-uint32_t rand_moodle() {
-    uint32_t prev = random_value;
-    uint64_t help = random_value;
+uint32_t rand_moodle(uint64_t &state) {
+    uint32_t prev = state;
+    uint64_t help = state;
     help = (help * RANDOM_MULT) % RANDOM_MOD;
-    random_value = (uint32_t) help;
+    state = (uint32_t) help;
     return prev;
 }
 
@@ -324,6 +318,43 @@ void parse_options(int argc, char **argv) {
             case 'h':
                 maxy = strtoul(optarg, nullptr, 10);
                 break;
+            case 'r':
+                rooms_count = strtoul(optarg, nullptr, 10);
+                break;
+            case 'c':
+                workers_count = strtoul(optarg, nullptr, 10);
+                break;
+            case 'l':
+                report_interval = strtoul(optarg, nullptr, 10);
+                break;
+            case 'n':
+                max_players = strtoul(optarg, nullptr, 10);
+                break;
+            case 'm':
+                log_memory = strtoul(optarg, nullptr, 10);
+                break;
+            case 'e':
+                reactor = true;
+                break;
+            case 'i':
+                shards_count = strtoul(optarg, nullptr, 10);
+                break;
+            case 'g':
+                if (strcmp(optarg, "hash") == 0)
+                    steer_by_cpu = false;
+                else if (strcmp(optarg, "cpu") == 0)
+                    steer_by_cpu = true;
+                else
+                    fatal("bad steering policy");
+                break;
+            case 'a':
+                if (strcmp(optarg, "skip") == 0)
+                    catch_up = CatchUp::SKIP;
+                else if (strcmp(optarg, "burst") == 0)
+                    catch_up = CatchUp::BURST;
+                else
+                    fatal("bad catch-up policy");
+                break;
             default:
                 syserr("UNKNOWN OPTION");
         }
@@ -344,406 +375,1309 @@ void validity_check() {
         fatal("BAD_PORT");
     if (0 == random_value || UINT32_MAX < random_value)
         fatal("bad seed");
+    if (0 == rooms_count || MAX_ROOMS < rooms_count || UINT16_MAX < port + rooms_count - 1)
+        fatal("bad number of rooms");
+    if (MAX_ROOMS < workers_count)
+        fatal("bad number of workers");
+    if (2 > max_players || MAX_PLAYERS_V2 < max_players)
+        fatal("bad number of players");
+    if (MAX_LOG_MEMORY < log_memory)
+        fatal("bad log memory");
+    if (0 == shards_count || MAX_SHARDS < shards_count)
+        fatal("bad number of shards");
 }
 
 
-void init_socket() {
-    sock_fd = socket(AF_INET6, SOCK_DGRAM, 0);
+int init_socket(uint16_t room_port, bool reuse_port) {
+    int sock_fd = socket(AF_INET6, SOCK_DGRAM, 0);
     if (sock_fd < 0)
         syserr("socket");
+    int one = 1;
+    if (reuse_port && setsockopt(sock_fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof one) < 0)
+        syserr("setsockopt");
 
     sockaddr_in6 server_adress{};
     server_adress.sin6_family = AF_INET6;
     server_adress.sin6_addr = in6addr_any;
-    server_adress.sin6_port = htobe16(port);
+    server_adress.sin6_port = htobe16(room_port);
     if (bind(sock_fd, (sockaddr *) &server_adress, sizeof(server_adress)) < 0)
         syserr("bind");
+    return sock_fd;
 }
 
-void disconnect_old(uint64_t now) {
-    auto iterator = connections.begin();
-    while (iterator != connections.end()) {
-        auto &player = *(iterator->second);
-        if (now - player.last_connected > MAX_IDLE_TIME) {
-            connections.erase(iterator++);
-        } else {
-            ++iterator;
-        }
+// sockets sharing the room's port, the kernel picks one for each datagram: by a hash of the
+// client's address (same client, same shard) or with steer_by_cpu by the cpu which got it
+vector<int> init_shards(uint16_t room_port) {
+    vector<int> fds;
+    for (uint64_t i = 0; i < shards_count; i++)
+        fds.push_back(init_socket(room_port, shards_count > 1));
+    if (shards_count > 1 && steer_by_cpu) {
+        sock_filter code[] = {{BPF_LD | BPF_W | BPF_ABS, 0, 0, (uint32_t) (SKF_AD_OFF + SKF_AD_CPU)},
+                              {BPF_ALU | BPF_MOD | BPF_K, 0, 0, (uint32_t) shards_count},
+                              {BPF_RET | BPF_A, 0, 0, 0}};
+        sock_fprog program{sizeof code / sizeof code[0], code};
+        if (setsockopt(fds[0], SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program, sizeof program) < 0)
+            syserr("setsockopt");
     }
+    return fds;
 }
 
-bool unique_name(string &name) {
-    for (auto &conn : connections) {
-        auto &player = *conn.second;
-        if (!player.name.empty() && player.name == name)
+bool valid_data(uint8_t direction, const string_view &name) {
+    if (name.size() > MAX_PLAYER_NAME_LENGTH)
+        return false;
+    if (direction > 2)
+        return false;
+    for (char c : name) {
+        if (!isgraph(c))
             return false;
     }
     return true;
 }
 
-void copy_to_buffer(uint8_t *buffer_start, Event &e) {
-    uint8_t *buffer = buffer_start;
-    memcpy(buffer, &e.header, EVENT_HEADER_SIZE);
-    buffer += EVENT_HEADER_SIZE;
-    memcpy(buffer, e.data.c_str(), e.data.size());
-    buffer += e.data.size();
-    memcpy(buffer, &e.checksum, sizeof(crc32_t));
-}
+// heartbeat as received, the name may be followed by the extension
+union ReceivedMessage {
+    client_to_serwer_mess message;
+    char bytes[MAX_CLIENT_MESS_LEN];
+};
+
+// heartbeat of a client, checked and decoded before it is applied
+struct ClientMessage {
+    ClientKey address;
+    uint64_t session_id;
+    uint8_t turn_direction;
+    uint32_t next_event_no;
+    uint32_t held_from; // client has events from here on, but not the ones before, 0 if it doesn't say
+    string_view name; // points into the receive buffer
+    uint8_t protocol_version; // which the server speaks with this client
+    uint8_t flags;
+};
 
-//copys message from events to buffer
-//returns (number of events copied, total lenght of copied data)
-pair<ssize_t, ssize_t> make_message(uint8_t *buffer, ssize_t starting_event_no) {
+// where one thread receives heartbeats
+struct ReceiveBuffers {
+    ReceivedMessage messages[RECEIVE_BATCH];
+    sockaddr_in6 client_addresses[RECEIVE_BATCH];
+    iovec parts[RECEIVE_BATCH];
+    mmsghdr headers[RECEIVE_BATCH];
+    vector<ClientMessage> parsed;
 
-    uint32_t game_id_be = htobe32(current_game.game_id);
-    memcpy(buffer, &game_id_be, sizeof(uint32_t));
-    ssize_t last_written = sizeof(uint32_t);
-    ssize_t num_of_events = 0;
+    ReceiveBuffers() : messages(), client_addresses(), parts(), headers(), parsed() {
+        parsed.reserve(RECEIVE_BATCH);
+    }
+};
 
-    auto it = current_game.events.begin() + starting_event_no;
+//appends decoded message to parsed, unless it makes no sense
+void parse_client_message(const ReceivedMessage &received, size_t mess_size,
+                          const sockaddr *client_address, vector<ClientMessage> &parsed) {
+    if (mess_size < CLIENT_HEADER_SIZE)
+        return;
 
-    while (it != current_game.events.end()
-           && last_written + it->size() < MAX_HOST_MESS_LEN) {
-        copy_to_buffer(buffer + last_written, *it);
-        last_written += it->size();
-        ++it;
-        num_of_events++;
+    auto &message = received.message;
+    uint8_t turn_direction = message.turn_direction;
+    string_view name(received.bytes + CLIENT_HEADER_SIZE, mess_size - CLIENT_HEADER_SIZE);
+    uint8_t protocol_version = PROTOCOL_V1;
+    uint8_t flags = 0;
+    uint32_t held_from = 0;
+    size_t name_end = name.find('\0');
+    if (name_end != string_view::npos) {
+        size_t extension_size = name.size() - name_end - 1;
+        if (extension_size == 0)
+            return;
+        client_extension_mess extension{};
+        memcpy(&extension, name.data() + name_end + 1, min(extension_size, sizeof extension));
+        if (extension.protocol_version < PROTOCOL_V2)
+            return;
+        // newer clients get the newest version we know
+        protocol_version = PROTOCOL_V2;
+        flags = extension.flags & (CLIENT_COMPACT | CLIENT_LOCKSTEP | CLIENT_SNAPSHOTS);
+        held_from = be32toh(extension.gap_end);
+        name = name.substr(0, name_end);
     }
-    return make_pair(num_of_events, last_written);
+    //reality check
+    if (!valid_data(turn_direction, name))
+        return;
+
+    parsed.push_back({ClientKey::from(client_address),
+                      be64toh(message.session_id), turn_direction,
+                      be32toh(message.next_expected_event_no), held_from,
+                      name, protocol_version, flags});
 }
 
-void send_to_address(const AddressWrapper &addr, uint8_t *buff, ssize_t len) {
-    if (sendto(sock_fd, buff, len, MSG_DONTWAIT, addr.get_address(), addr.size()) < len) {
-        if (errno == EWOULDBLOCK || errno == EAGAIN) {
-            // not my problem
-            return;
-        } else {
-            syserr("write-failure");
+void pin_to_cpu(unsigned cpu) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    // pinning is only a hint, work goes on without it
+    pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+}
+
+/* Batched sending */
+
+// All datagrams of one tick for all recipients, sent with as few sendmmsg calls as possible.
+// Messages are grouped by recipient, so a recipient whose datagram didn't fit into the
+// socket buffer loses only the rest of its own datagrams.
+struct SendBatch {
+    uint32_t game_id_be = 0;
+    vector<mmsghdr> messages{};
+    vector<array<iovec, 4>> parts{};
+    vector<uint32_t> recipient_end{}; // index of the first message to the next recipient
+    uint64_t syscalls = 0, datagrams = 0, dropped = 0;
+
+    void start(uint32_t game_id, size_t size) {
+        game_id_be = htobe32(game_id);
+        messages.clear();
+        parts.clear();
+        recipient_end.clear();
+        // parts are pointed to by messages, so they must not move
+        messages.reserve(size);
+        parts.reserve(size);
+        recipient_end.reserve(size);
+    }
+
+    void add_message(const sockaddr_in6 &addr, const array<iovec, 4> &message_parts, size_t parts_count,
+                     uint32_t end) {
+        parts.push_back(message_parts);
+        mmsghdr header{};
+        header.msg_hdr.msg_name = const_cast<sockaddr_in6 *>(&addr);
+        header.msg_hdr.msg_namelen = sizeof(sockaddr_in6);
+        header.msg_hdr.msg_iov = parts.back().data();
+        header.msg_hdr.msg_iovlen = parts_count;
+        messages.push_back(header);
+        recipient_end.push_back(end);
+    }
+
+    void add_recipient(const sockaddr_in6 &addr, const vector<EventSlice> &datagrams_to_send) {
+        uint32_t end = messages.size() + datagrams_to_send.size();
+        for (auto &message : datagrams_to_send) {
+            add_message(addr, {iovec{&game_id_be, sizeof(uint32_t)},
+                               iovec{const_cast<uint8_t *>(message.data), message.len}}, 2, end);
         }
     }
-}
 
-//bundles messages and sends them to one host
-void send_events_to_one_client(const AddressWrapper &address, uint32_t next_event) {
-    if (next_event >= current_game.events.size())
-        return;
+    // datagrams must stay in place until flush
+    void add_recipient(const sockaddr_in6 &addr, const vector<CompactDatagram> &datagrams_to_send) {
+        uint32_t end = messages.size() + datagrams_to_send.size();
+        for (auto &message : datagrams_to_send) {
+            add_message(addr, {iovec{&game_id_be, sizeof(uint32_t)},
+                               iovec{const_cast<compact_header_mess *>(&message.header), sizeof message.header},
+                               iovec{const_cast<uint8_t *>(message.records.data), message.records.len},
+                               iovec{const_cast<crc32_t *>(&message.crc), sizeof message.crc}}, 4, end);
+        }
+    }
 
-    uint8_t buffer[MAX_HOST_MESS_LEN];
-    while (next_event < current_game.events.size()) {
-        auto[event_num, len] = make_message(buffer, next_event);
-        next_event += event_num;
+    void flush(int sock_fd) {
+        size_t sent = 0;
+        while (sent < messages.size()) {
+            int result = sendmmsg(sock_fd, messages.data() + sent, messages.size() - sent, MSG_DONTWAIT);
+            syscalls++;
+            if (result < 0) {
+                if (errno == EWOULDBLOCK || errno == EAGAIN) {
+                    // not my problem, but don't stuff more into this recipient
+                    dropped += recipient_end[sent] - sent;
+                    sent = recipient_end[sent];
+                    continue;
+                } else {
+                    syserr("write-failure");
+                }
+            }
+            sent += result;
+        }
+        datagrams += messages.size();
+    }
+};
 
-        send_to_address(address, buffer, len);
+/* Shards */
+
+struct Room;
+
+enum class InputKind : uint8_t {
+    JOIN, // first heartbeat of a connection, its JoinRequest comes along
+    HEARTBEAT,
+    LEAVE // connection timed out or started another session
+};
+
+// what the tick of a room gets from a shard about one of the shard's connections
+struct InputUpdate {
+    Room *room;
+    uint32_t connection; // number of the connection in the room, see RoomShard::first_connection
+    uint32_t next_event_no;
+    uint32_t held_from;
+    InputKind kind;
+    uint8_t turn_direction;
+    uint8_t flags;
+};
+
+// rest of the first heartbeat, which the room needs to let a connection in
+struct JoinRequest {
+    sockaddr_in6 address;
+    uint8_t protocol_version;
+    uint8_t name_len;
+    char name[MAX_PLAYER_NAME_LENGTH];
+
+    [[nodiscard]] string_view player_name() const {
+        return {name, name_len};
     }
-}
+};
 
-//bundles messages and sends them to all clients
-void send_to_all_clients(size_t event_start) {
-    uint8_t buffer[MAX_HOST_MESS_LEN];
+// updates in the order a shard made them, JOIN ones take their requests from joins in turn
+struct InputBatch {
+    vector<InputUpdate> updates;
+    vector<JoinRequest> joins;
 
-    while (event_start < current_game.events.size()) {
+    [[nodiscard]] bool empty() const {
+        return updates.empty();
+    }
 
-        auto[event_num, len] = make_message(buffer, event_start);
-        event_start += event_num;
+    void clear() {
+        updates.clear();
+        joins.clear();
+    }
 
-        for (auto &conn : connections) {
-            send_to_address(conn.first, buffer, len);
+    void append(InputBatch &batch) {
+        updates.insert(updates.end(), batch.updates.begin(), batch.updates.end());
+        joins.insert(joins.end(), batch.joins.begin(), batch.joins.end());
+        batch.clear();
+    }
+};
+
+// client a shard knows, the shard alone looks at it
+struct ShardClient {
+    uint64_t session_id;
+    uint64_t connection_no; // tells apart connections from the same address
+    uint64_t last_connected;
+    uint8_t protocol_version;
+    uint8_t name_len;
+    char name[MAX_PLAYER_NAME_LENGTH];
+
+    [[nodiscard]] string_view player_name() const {
+        return {name, name_len};
+    }
+};
+
+// One receiving socket of a room with the connections the kernel steers to it. The shard
+// receives and checks heartbeats, tells sessions apart and times connections out on its own,
+// the tick of the room gets only InputUpdates from it. All of it belongs to one thread.
+struct RoomShard {
+    Room *room;
+    int sock_fd;
+    uint32_t first_connection; // connections of the room made by this shard are numbered from here
+    ConnectionTable connections; // player of a connection is its number in the shard
+    vector<ShardClient> clients; // by number in the shard
+    vector<uint32_t> free_clients;
+    uint64_t connections_made = 0;
+    atomic<uint64_t> heartbeats{0}; // received and valid, read by reports
+
+    // connection waiting in idle_timers for its time to run out
+    struct IdleTimer {
+        ClientKey address;
+        uint64_t connection_no;
+    };
+
+    TimerWheel<IdleTimer> idle_timers{IDLE_WHEEL_RESOLUTION, IDLE_WHEEL_SLOTS, current_time_in_microseconds()};
+
+    RoomShard(Room *room, int sock_fd, uint32_t first_connection) :
+            room(room), sock_fd(sock_fd), first_connection(first_connection),
+            connections(max_players, random_device{}()), clients(max_players), free_clients() {
+        for (uint32_t i = max_players; i > 0; i--)
+            free_clients.push_back(i - 1);
+    }
+
+    ~RoomShard() {
+        if (close(sock_fd) != 0) syserr("close");
+    }
+
+    void add_update(InputBatch &out, InputKind kind, uint32_t client, const ClientMessage *message) {
+        InputUpdate update{room, first_connection + client, 0, 0, kind, 0, 0};
+        if (message != nullptr) {
+            update.next_event_no = message->next_event_no;
+            update.held_from = message->held_from;
+            update.turn_direction = message->turn_direction;
+            update.flags = message->flags;
         }
+        out.updates.push_back(update);
     }
 
-}
+    //heartbeats only refresh last_connected, connection is looked at again when its timer runs out
+    void disconnect_old(uint64_t now, InputBatch &out) {
+        idle_timers.expire(now, [this, now, &out](IdleTimer &timer) {
+            auto *conn = connections.find(timer.address);
+            if (conn == nullptr || clients[conn->player].connection_no != timer.connection_no)
+                return; // already gone
+            auto &client = clients[conn->player];
+            if (now - client.last_connected > MAX_IDLE_TIME) {
+                disconnect(*conn, out);
+            } else {
+                idle_timers.schedule(client.last_connected + MAX_IDLE_TIME + 1, timer);
+            }
+        });
+    }
 
-void new_client(const AddressWrapper &address, uint64_t session_id,
-                uint8_t turn_direction, uint32_t next_event_no, string &name) {
+    void disconnect(Connection &conn, InputBatch &out) {
+        uint32_t client = conn.player;
+        add_update(out, InputKind::LEAVE, client, nullptr);
+        free_clients.push_back(client);
+        ClientKey key = conn.key;
+        connections.erase(key);
+    }
 
-    if (!unique_name(name))
-        return;
+    void new_client(const ClientMessage &message, uint64_t now, InputBatch &out) {
+        if (connections.full())
+            return;
+        uint32_t client = free_clients.back();
+        free_clients.pop_back();
+        auto &conn = connections.insert(message.address, client);
+        auto &data = clients[client];
+        data.session_id = message.session_id;
+        data.connection_no = ++connections_made;
+        data.last_connected = now;
+        data.protocol_version = message.protocol_version;
+        data.name_len = message.name.size();
+        memcpy(data.name, message.name.data(), message.name.size());
+        idle_timers.schedule(now + MAX_IDLE_TIME + 1, IdleTimer{message.address, data.connection_no});
+
+        add_update(out, InputKind::JOIN, client, &message);
+        JoinRequest request{conn.address, message.protocol_version, data.name_len, {}};
+        memcpy(request.name, data.name, data.name_len);
+        out.joins.push_back(request);
+    }
 
-    if (connections.size() == MAX_CONNECTED)
-        return;
+    void process_message(const ClientMessage &message, uint64_t now, InputBatch &out) {
+        auto *conn = connections.find(message.address);
+        if (conn != nullptr && clients[conn->player].session_id != message.session_id) {
+            disconnect(*conn, out);
+            conn = nullptr;
+        }
+        if (conn == nullptr) {
+            new_client(message, now, out);
+            return;
+        }
+        auto &client = clients[conn->player];
+        if (message.name != client.player_name() || message.protocol_version != client.protocol_version)
+            return;
+        client.last_connected = now;
+        add_update(out, InputKind::HEARTBEAT, conn->player, &message);
+    }
 
-    connections.insert_or_assign(address, PlayerWrapper(session_id, turn_direction, name));
+    //receives what waits in the socket without blocking and turns it into updates,
+    //returns the number of datagrams
+    int receive(ReceiveBuffers &buffers, InputBatch &out) {
+        for (int i = 0; i < RECEIVE_BATCH; i++) {
+            buffers.parts[i] = {&buffers.messages[i], sizeof(ReceivedMessage)};
+            buffers.headers[i] = {};
+            buffers.headers[i].msg_hdr.msg_name = &buffers.client_addresses[i];
+            buffers.headers[i].msg_hdr.msg_namelen = sizeof(sockaddr_in6);
+            buffers.headers[i].msg_hdr.msg_iov = &buffers.parts[i];
+            buffers.headers[i].msg_hdr.msg_iovlen = 1;
+        }
+        int received = recvmmsg(sock_fd, buffers.headers, RECEIVE_BATCH, MSG_DONTWAIT, nullptr);
+        if (received < 0) {
+            if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)
+                return 0;
+            syserr("recvmmsg");
+        }
 
-    send_events_to_one_client(address, next_event_no);
-}
+        auto &parsed = buffers.parsed;
+        parsed.clear();
+        for (int i = 0; i < received; i++)
+            parse_client_message(buffers.messages[i], buffers.headers[i].msg_len,
+                                 (sockaddr *) &buffers.client_addresses[i], parsed);
+        if (parsed.empty())
+            return received;
+
+        heartbeats.fetch_add(parsed.size(), memory_order_relaxed);
+        uint64_t now = current_time_in_microseconds();
+        disconnect_old(now, out);
+        for (auto &message : parsed)
+            process_message(message, now, out);
+        return received;
+    }
 
-void send_to_known_client(const AddressWrapper &address, uint64_t session_id,
-                          uint8_t turn_direction, uint32_t next_event_no, string &name) {
+    //receives everything waiting in the socket without blocking
+    void drain(ReceiveBuffers &buffers, InputBatch &out) {
+        while (receive(buffers, out) == RECEIVE_BATCH) {}
+    }
+};
 
+/* Rooms */
+
+// One independent game: its own port (port + room number), players, event log and tick state.
+// Its shards know the connections and hand their heartbeats over as InputUpdates, the worker
+// which ticks the room applies them and is the only thread which touches the rest.
+struct Room {
+    static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+    uint32_t room_no;
+    uint32_t worker_no = 0;
+    vector<unique_ptr<RoomShard>> shards;
+    int sock_fd; // of the first shard, everything is sent through it
+    // a player which left during the game keeps its slot until the game ends
+    PlayerSlab players{2 * (uint32_t) max_players};
+    vector<uint32_t> slot_of; // of every connection the shards may make, NO_SLOT if not let in
+    unordered_map<uint32_t, JoinRequest> refused; // connections not let in, tried again on heartbeats
+    GameData current_game{};
+    unordered_set<string_view> names; // of connected players, point into the slab
+    vector<uint8_t> event_data; // data of the event being generated
+    vector<pair<string_view, uint32_t>> joining; // names and slots of players of a new game
+    uint64_t random_value;
+    uint64_t resent = 0, deferred = 0, dropped = 0; // datagrams sent again, held back by pacers, not sent
+    bool playing = false;
+    TickSchedule schedule{1000000 / rounds_per_second, catch_up};
+    SendBatch batch{};
+
+    Room(uint32_t room_no, uint64_t seed) :
+            room_no(room_no), shards(), sock_fd(), slot_of(shards_count * max_players, NO_SLOT),
+            random_value(seed) {
+        vector<int> fds = init_shards(port + room_no);
+        for (size_t i = 0; i < fds.size(); i++)
+            shards.push_back(make_unique<RoomShard>(this, fds[i], i * max_players));
+        sock_fd = fds[0];
+        names.reserve(max_players);
+    }
 
-    auto iter = connections.find(address);
-    if (iter == connections.end())
-        return;
+    uint32_t rand_moodle() {
+        return ::rand_moodle(random_value);
+    }
 
-    auto &player_data = *(iter->second);
+    bool unique_name(const string_view &name) {
+        return name.empty() || names.count(name) == 0;
+    }
 
-    if (session_id != player_data.session_id) {
-        connections.erase(iter);
+    //events starting with starting_event_no which fit in one message after game id, cut once per game
+    // datagram with the event, shared by all clients which need it again
+    static EventSlice make_message(EventStream &stream, uint32_t event_no) {
+        return stream.datagrams.get(stream.events, event_no, MAX_HOST_MESS_LEN - sizeof(uint32_t),
+                                    [](const EventSlice &slice) { return slice; });
+    }
 
-        new_client(address, session_id,
-                   turn_direction, next_event_no, name);
-        return;
+    // datagram starting right with the event, for the broadcast of new events
+    static EventSlice new_message(const EventStream &stream, uint32_t event_no) {
+        return stream.events.slice(event_no, MAX_HOST_MESS_LEN - sizeof(uint32_t));
     }
 
-    if (name != player_data.name)
-        return;
+    static uint32_t datagram_len(const EventSlice &message) {
+        return sizeof(uint32_t) + message.len;
+    }
 
-    player_data.set_direction(turn_direction);
+    static uint32_t datagram_len(const CompactDatagram &message) {
+        return sizeof(uint32_t) + sizeof message.header + message.records.len + sizeof message.crc;
+    }
 
-    player_data.last_connected = current_time_in_microseconds();
-    send_events_to_one_client(address, next_event_no);
+    //sends game id and events straight from the event log, false if the socket buffer is full
+    bool send_to_address(const sockaddr_in6 &addr, const EventSlice &message) const {
+        uint32_t game_id_be = htobe32(current_game.game_id);
+        iovec parts[2] = {{&game_id_be, sizeof(uint32_t)},
+                          {const_cast<uint8_t *>(message.data), message.len}};
+        return send_parts(addr, parts, 2);
+    }
 
-}
+    bool send_to_address(const sockaddr_in6 &addr, const CompactDatagram &message) const {
+        uint32_t game_id_be = htobe32(current_game.game_id);
+        iovec parts[4] = {{&game_id_be, sizeof(uint32_t)},
+                          {const_cast<compact_header_mess *>(&message.header), sizeof message.header},
+                          {const_cast<uint8_t *>(message.records.data), message.records.len},
+                          {const_cast<crc32_t *>(&message.crc), sizeof message.crc}};
+        return send_parts(addr, parts, 4);
+    }
 
-bool valid_data(const client_to_serwer_mess &mess, uint8_t direction, size_t name_size) {
-    if (name_size > MAX_PLAYER_NAME_LENGTH)
-        return false;
-    if (direction > 2)
-        return false;
-    for (size_t i = 0; i < name_size; i++) {
-        if (!isgraph(mess.player_name[i]))
+    bool send_parts(const sockaddr_in6 &addr, iovec *parts, size_t parts_count) const {
+        msghdr header{};
+        header.msg_name = const_cast<sockaddr_in6 *>(&addr);
+        header.msg_namelen = sizeof(sockaddr_in6);
+        header.msg_iov = parts;
+        header.msg_iovlen = parts_count;
+
+        ssize_t len = 0;
+        for (size_t i = 0; i < parts_count; i++)
+            len += parts[i].iov_len;
+        if (sendmsg(sock_fd, &header, MSG_DONTWAIT) < len) {
+            if (errno == EWOULDBLOCK || errno == EAGAIN) {
+                // not my problem, the window sends it again
+                return false;
+            } else {
+                syserr("write-failure");
+            }
+        }
+        return true;
+    }
+
+    // one datagram to a client, unless its pacer or the socket buffer says no
+    template<typename Message>
+    bool send_paced(PlayerData &player, const sockaddr_in6 &address, const Message &message, uint64_t now) {
+        if (!player.pacer.take(datagram_len(message), now)) {
+            deferred++;
             return false;
+        }
+        if (!send_to_address(address, message)) {
+            dropped++;
+            return false;
+        }
+        return true;
     }
-    return true;
-}
 
-string get_name(const char *name_buff, size_t size) {
-    string result;
-    result.append(name_buff, size);
-    return result;
-}
+    // record stream a client gets instead of its protocol's events, if any
+    // (lockstep clients read compact datagrams too, for games without lockstep stream)
+    RecordStream *record_stream(uint8_t flags) {
+        if ((flags & CLIENT_LOCKSTEP) && current_game.lockstep.kept)
+            return &current_game.lockstep;
+        if (flags & (CLIENT_COMPACT | CLIENT_LOCKSTEP)) {
+            make_compact_records();
+            return &current_game.compact;
+        }
+        return nullptr;
+    }
 
-void process_message(const client_to_serwer_mess &message, size_t mess_size,
-                     const sockaddr *client_address) {
+    // events of the protocol, up to date
+    EventStream &event_stream(uint8_t protocol_version) {
+        if (protocol_version == PROTOCOL_V1)
+            make_v1_events();
+        return current_game.stream(protocol_version);
+    }
 
+    // sends events after what the window has sent until at least until, from records if not null,
+    // false if pacing or the socket stopped it
+    bool send_events_until(PlayerData &player, const sockaddr_in6 &address, RecordStream *records,
+                           uint32_t until, uint64_t now) {
+        auto &window = player.window;
+        uint32_t next_event = window.sent_until();
+        if (records != nullptr) {
+            auto &stream = *records;
+            for (; stream.kept && next_event < min(until, stream.size()); next_event = window.sent_until()) {
+                CompactDatagram message = stream.datagram(next_event);
+                if (!send_paced(player, address, message, now))
+                    return false;
+                if (window.resending(next_event))
+                    resent++;
+                window.sent_to(message.records.first + message.records.events, now);
+            }
+            return true;
+        }
+        auto &stream = event_stream(player.protocol_version);
+        if (!stream.kept)
+            return true;
+        for (; next_event < min(until, stream.events.size()); next_event = window.sent_until()) {
+            EventSlice message = make_message(stream, next_event);
+            if (!send_paced(player, address, message, now))
+                return false;
+            if (window.resending(next_event))
+                resent++;
+            window.sent_to(message.first + message.events, now);
+        }
+        return true;
+    }
 
-    uint64_t session_id = be64toh(message.session_id);
-    uint8_t turn_direction = message.turn_direction;
+    // snapshot is taken again once enough events came after it, but not more often than
+    // every quarter of the game, so merging and encoding the board stays cheap
+    void refresh_snapshot() {
+        auto &snapshot = current_game.snapshot;
+        uint32_t events = current_game.stream(PROTOCOL_V2).events.size();
+        if (events - snapshot.first_event() >= max<uint32_t>(SNAPSHOT_MIN_EVENTS, snapshot.first_event() / 4))
+            snapshot.take(current_game.stream(PROTOCOL_V2).events, events, current_game.worms);
+    }
 
-    uint32_t next_event_no = be32toh(message.next_expected_event_no);
+    // client which has nothing but the names gets the latest snapshot instead of events before it
+    bool catching_up(uint8_t protocol_version, uint8_t flags, const RecordStream *records, uint32_t next_event) {
+        if (protocol_version < PROTOCOL_V2 || !(flags & CLIENT_SNAPSHOTS) || records == &current_game.lockstep ||
+            next_event > current_game.names_events)
+            return false;
+        refresh_snapshot();
+        return current_game.snapshot.first_event() > current_game.names_events;
+    }
 
-    uint32_t name_size = mess_size - CLIENT_HEADER_SIZE;
-    //reality check
-    if (!valid_data(message, turn_direction, name_size))
-        return;
+    // sends what the window hasn't sent yet, the snapshot instead of old events if the client catches up
+    void send_pending(PlayerData &player, const sockaddr_in6 &address, uint32_t until, uint64_t now) {
+        auto &window = player.window;
+        RecordStream *records = record_stream(player.flags);
+        if (catching_up(player.protocol_version, player.flags, records, window.acknowledged())) {
+            if (!send_events_until(player, address, records, current_game.names_events, now))
+                return;
+            auto &snapshot = current_game.snapshot;
+            uint32_t &fragment = window.fragments_sent(snapshot.first_event());
+            while (fragment < snapshot.fragments_count()) {
+                EventSlice message = snapshot.fragments_from(fragment);
+                if (!send_paced(player, address, message, now))
+                    return;
+                fragment += message.events;
+            }
+            window.sent_to(snapshot.first_event(), now);
+        }
+        send_events_until(player, address, records, until, now);
+    }
 
-    string name = get_name(message.player_name, name_size);
+    //bundles messages and sends them to one host, only what it needs and at its pace
+    void send_events_to_one_client(PlayerData &player, uint32_t next_event, uint32_t held_from) {
+        uint64_t now = current_time_in_microseconds();
+        player.window.acknowledge(next_event, held_from, now);
+        player.window.retransmit_if_due(now, !playing);
+        send_pending(player, player.address, UINT32_MAX, now);
+    }
 
-    auto address = AddressWrapper::makeAddressWrapper(client_address);
+    //bundles messages and sends them to all clients in one batch
+    void send_to_all_clients(StreamSizes start) {
+        // streams made from v2 events are brought up to date only for their readers,
+        // lockstep is made only while somebody may read it
+        bool lockstep_read = false;
+        for (uint32_t slot : players.connected()) {
+            auto &player = players[slot];
+            if (record_stream(player.flags) == nullptr)
+                event_stream(player.protocol_version);
+            lockstep_read = lockstep_read || (player.flags & CLIENT_LOCKSTEP);
+        }
+        current_game.lockstep.kept = current_game.lockstep.kept && lockstep_read;
+
+        StreamSizes first = start, end = current_game.events_count();
+        auto &event_start = start.events;
+        // compact stream has the same events as v2
+        uint32_t compact_start = event_start[PROTOCOL_V2 - 1];
+        vector<EventSlice> messages[PROTOCOLS];
+        size_t most = 0;
+        for (int i = 0; i < PROTOCOLS; i++) {
+            auto &stream = current_game.streams[i];
+            if (!stream.kept)
+                continue;
+            while (event_start[i] < stream.events.size()) {
 
-    auto iter = connections.find(address);
+                EventSlice message = new_message(stream, event_start[i]);
+                event_start[i] += message.events;
+                messages[i].push_back(message);
+            }
+            most = max(most, messages[i].size());
+        }
+        vector<CompactDatagram> compact_messages;
+        while (current_game.compact.kept && compact_start < current_game.compact.size()) {
+            CompactDatagram message = current_game.compact.datagram_from(compact_start);
+            compact_start += message.records.events;
+            compact_messages.push_back(message);
+        }
+        most = max(most, compact_messages.size());
+        vector<CompactDatagram> lockstep_messages;
+        while (current_game.lockstep.kept && start.lockstep < current_game.lockstep.size()) {
+            CompactDatagram message = current_game.lockstep.datagram_from(start.lockstep);
+            start.lockstep += message.records.events;
+            lockstep_messages.push_back(message);
+        }
+        most = max(most, lockstep_messages.size());
+
+        uint64_t now = current_time_in_microseconds();
+        batch.start(current_game.game_id, most * players.connected().size());
+        for (uint32_t slot : players.connected()) {
+            auto &player = players[slot];
+            RecordStream *records = record_stream(player.flags);
+            uint32_t from = first.events[player.protocol_version - 1], to = end.events[player.protocol_version - 1];
+            if (records == &current_game.lockstep) {
+                from = first.lockstep;
+                to = end.lockstep;
+            }
+            // client without the events before these would ignore them, it gets what it misses at its pace
+            if (player.window.sent_until() < from) {
+                send_pending(player, player.address, to, now);
+                continue;
+            }
+            if (records == &current_game.lockstep)
+                batch.add_recipient(player.address, lockstep_messages);
+            else if (records == &current_game.compact)
+                batch.add_recipient(player.address, compact_messages);
+            else
+                batch.add_recipient(player.address, messages[player.protocol_version - 1]);
+            player.window.sent_to(to, now);
+        }
+        batch.flush(sock_fd);
+    }
 
-    if (iter == connections.end()) {
-        new_client(address, session_id,
-                   turn_direction, next_event_no, name);
-    } else {
-        send_to_known_client(address, session_id,
-                             turn_direction, next_event_no, name);
+    // lets the connection in, unless its name is taken or the room is full
+    void new_client(const InputUpdate &update, const JoinRequest &request) {
+        string_view name = request.player_name();
+        if (!unique_name(name) || players.connected().size() >= max_players) {
+            refused[update.connection] = request;
+            return;
+        }
+
+        uint64_t now = current_time_in_microseconds();
+        uint32_t slot = players.take(request.address, update.turn_direction, name, request.protocol_version,
+                                     update.flags, now);
+        slot_of[update.connection] = slot;
+        if (!name.empty())
+            names.insert(players[slot].name);
+        refused.erase(update.connection); // request and name may be gone now
+
+        send_events_to_one_client(players[slot], update.next_event_no, update.held_from);
     }
 
-}
+    void send_to_known_client(uint32_t slot, const InputUpdate &update) {
+        auto &player_data = players[slot];
+        // lockstep clients fall back to events when they get out of sync
+        player_data.flags = update.flags;
 
-bool time_to_start() {
-    return connected_players == ready_players && connected_players > 1;
-}
+        players.set_direction(slot, update.turn_direction);
+        if (player_data.in_game)
+            current_game.worms.turn_direction[player_data.player_no] = update.turn_direction;
 
+        send_events_to_one_client(player_data, update.next_event_no, update.held_from);
+    }
 
-//listens for all clients in a loop
-[[noreturn]] void do_listen() {
+    void disconnect(uint32_t connection) {
+        refused.erase(connection);
+        uint32_t slot = slot_of[connection];
+        if (slot == NO_SLOT)
+            return;
+        names.erase(players[slot].name);
+        players.disconnected(slot);
+        slot_of[connection] = NO_SLOT;
+    }
 
-    client_to_serwer_mess message;
-    sockaddr_in6 client_address{};
-    int client_size = sizeof(client_address);
-    size_t mess_size;
-    for (;;) {
-        if ((mess_size = recvfrom(sock_fd, &message, sizeof message, 0, (sockaddr *) &client_address,
-                                  (socklen_t *) &client_size)) < CLIENT_HEADER_SIZE) {
-            continue;
-        } else {
-            lock_guard<mutex> lock(mut);
-            disconnect_old(current_time_in_microseconds());
-            process_message(message, mess_size, (sockaddr *) &client_address);
+    // join is the request of a JOIN update
+    void apply(const InputUpdate &update, const JoinRequest *join) {
+        switch (update.kind) {
+            case InputKind::JOIN:
+                new_client(update, *join);
+                break;
+            case InputKind::HEARTBEAT:
+                if (slot_of[update.connection] != NO_SLOT) {
+                    send_to_known_client(slot_of[update.connection], update);
+                } else {
+                    auto request = refused.find(update.connection);
+                    if (request != refused.end())
+                        new_client(update, request->second);
+                }
+                break;
+            case InputKind::LEAVE:
+                disconnect(update.connection);
+                break;
+        }
+    }
+
+    // idle room has no rounds due, the game starts once a batch of inputs makes everybody ready
+    void start_if_ready() {
+        if (!playing && time_to_start())
+            schedule.start(current_time_in_microseconds());
+    }
 
-            if (time_to_start())
-                wait_for_players.notify_all();
+    bool time_to_start() const {
+        return players.counters.connected_players == players.counters.ready_players &&
+               players.counters.connected_players > 1;
+    }
+
+    // v1 stream is kept when v1 can describe the game: player numbers fit in a byte
+    // and NEW_GAME fits in a datagram, otherwise v1 clients sit this game out
+    static bool fits_v1(uint32_t players_count, size_t names_len) {
+        return players_count <= MAX_PLAYERS_V1 && names_len <= NEW_GAME_NAMES_LEN;
+    }
+
+    void add_players() {
+        joining.clear();
+        size_t names_len = 0;
+        for (uint32_t slot : players.connected()) {
+            auto &name = players[slot].name;
+            if (!name.empty()) {
+                joining.emplace_back(name, slot);
+                names_len += name.size() + 1;
+            }
+        }
+        bool v1_kept = fits_v1(joining.size(), names_len);
+        if (!v1_kept) {
+            joining.erase(remove_if(joining.begin(), joining.end(), [this](const pair<string_view, uint32_t> &p) {
+                return players[p.second].protocol_version == PROTOCOL_V1;
+            }), joining.end());
         }
+        // names are unique, so comparing them alone is enough
+        sort(joining.begin(), joining.end());
+
+        for (auto &p : joining) {
+            players[p.second].player_no = current_game.players.size();
+            current_game.players.push_back(p.second);
+            players.join_game(p.second);
+        }
+        bool lockstep_read = any_of(players.connected().begin(), players.connected().end(), [this](uint32_t slot) {
+            return players[slot].flags & CLIENT_LOCKSTEP;
+        });
+        current_game.stream(PROTOCOL_V1).kept = v1_kept;
+        current_game.stream(PROTOCOL_V2).kept = true;
+        current_game.compact.kept = true;
+        current_game.lockstep.kept = lockstep_read && LockstepStream::fits(current_game.players.size());
     }
-}
 
-void add_players() {
-    for (auto &conn : connections) {
-        if (!conn.second->name.empty())
-            current_game.players.push_back(conn.second);
+    // appends player names, from the first one not yet appended, while they fit in max_len
+    size_t append_names(size_t next_player, size_t max_len) {
+        size_t len = event_data.size();
+        for (; next_player < current_game.players.size(); next_player++) {
+            //copy null bit
+            auto &name = players[current_game.players[next_player]].name;
+            if (event_data.size() - len + name.size() + 1 > max_len)
+                break;
+            event_data.insert(event_data.end(), name.c_str(), name.c_str() + name.size() + 1);
+        }
+        return next_player;
     }
-    sort(current_game.players.begin(), current_game.players.end());
 
-    current_game.active_players = current_game.players.size();
-}
+    template<typename T>
+    void start_event_data(const T &data) {
+        event_data.resize(sizeof data);
+        memcpy(event_data.data(), &data, sizeof data);
+    }
 
+    // v2 names are spread over as many events as needed, each of them fits in a datagram
+    void generate_new_game() {
+        auto &v2 = current_game.stream(PROTOCOL_V2);
+        start_event_data(new_game_data_v2_mess{htobe32(maxx), htobe32(maxy),
+                                               htobe32(current_game.players.size())});
+        size_t next_player = append_names(0, NEW_GAME_V2_NAMES_LEN);
+        v2.events.append(NEW_GAME_TYPE, event_data.data(), event_data.size());
+        while (next_player < current_game.players.size()) {
+            event_data.clear();
+            next_player = append_names(next_player, PLAYER_NAMES_LEN);
+            v2.events.append(PLAYER_NAMES_TYPE, event_data.data(), event_data.size());
+        }
+        current_game.names_events = v2.events.size();
+    }
 
-void generate_new_game() {
-    string data;
-    uint32_t x_net = htobe32(maxx);
-    uint32_t y_net = htobe32(maxy);
-    data.append((char *) &x_net, 4);
-    data.append((char *) &y_net, 4);
-    for (auto &p : current_game.players) {
-        //copy null bit
-        data.append(p->name.c_str(), p->name.size() + 1);
+    // lockstep clients get the same names, then everything else they need to play the game
+    void generate_lockstep_new_game() {
+        auto &lockstep = current_game.lockstep;
+        if (!lockstep.kept)
+            return;
+        start_event_data(new_game_data_v2_mess{htobe32(maxx), htobe32(maxy),
+                                               htobe32(current_game.players.size())});
+        size_t next_player = append_names(0, NEW_GAME_V2_NAMES_LEN);
+        lockstep.new_game(event_data.data(), event_data.size());
+        while (next_player < current_game.players.size()) {
+            event_data.clear();
+            next_player = append_names(next_player, PLAYER_NAMES_LEN);
+            lockstep.player_names(event_data.data(), event_data.size());
+        }
+        lockstep.rules(turning_speed);
     }
-    current_game.events.emplace_back(data, current_game.events.size(), NEW_GAME_TYPE);
-}
 
-void generate_pixel(uint32_t x, uint32_t y, uint8_t player_num) {
-    current_game.board[x][y] = true;
+    void generate_pixel(uint32_t x, uint32_t y, uint32_t player_num) {
+        pixel_data_v2_mess data{htobe16(player_num), htobe32(x), htobe32(y)};
+        current_game.stream(PROTOCOL_V2).events.append(PIXEL_TYPE, &data, sizeof data);
+    }
 
-    string data;
-    uint32_t x_net = htobe32(x);
-    uint32_t y_net = htobe32(y);
+    void generate_player_eliminated(uint32_t player_num) {
+        eliminated_data_v2_mess data{htobe16(player_num)};
+        current_game.stream(PROTOCOL_V2).events.append(ELIMINATED_TYPE, &data, sizeof data);
+    }
 
-    data += player_num;
-    data.append((char *) &x_net, 4);
-    data.append((char *) &y_net, 4);
 
-    current_game.events.emplace_back(data, current_game.events.size(), PIXEL_TYPE);
-}
+    void generate_end_game() {
+        current_game.end_game(players);
 
-void generate_player_eliminated(uint8_t player_num) {
-    current_game.players[player_num]->eliminated = true;
-    current_game.active_players--;
+        current_game.stream(PROTOCOL_V2).events.append(END_GAME_TYPE, nullptr, 0);
+        if (current_game.lockstep.kept)
+            current_game.lockstep.end_game();
+    }
 
-    string data;
-    data += player_num;
-    current_game.events.emplace_back(data, current_game.events.size(), ELIMINATED_TYPE);
-}
+    // v1 events of the v2 events not translated yet, all names go in NEW_GAME as v1 is kept only if they fit
+    void make_v1_events() {
+        auto &v1 = current_game.stream(PROTOCOL_V1);
+        auto &v2 = current_game.stream(PROTOCOL_V2).events;
+        uint32_t &next = current_game.v1_made_until;
+        if (!v1.kept || next == v2.size())
+            return;
+        if (next == 0) {
+            for (; next < current_game.names_events; next++) {
+                LoggedEvent event = v2.event(next);
+                const uint8_t *names = event.data, *names_end = event.data + event.len;
+                if (event.type == NEW_GAME_TYPE) {
+                    new_game_data_v2_mess data;
+                    memcpy(&data, event.data, sizeof data);
+                    start_event_data(new_game_data_mess{data.maxx, data.maxy});
+                    names += sizeof data;
+                }
+                event_data.insert(event_data.end(), names, names_end);
+            }
+            v1.events.append(NEW_GAME_TYPE, event_data.data(), event_data.size());
+        }
+        for (; next < v2.size(); next++) {
+            LoggedEvent event = v2.event(next);
+            if (event.type == PIXEL_TYPE) {
+                pixel_data_v2_mess data;
+                memcpy(&data, event.data, sizeof data);
+                pixel_data_mess v1_data{(uint8_t) be16toh(data.player_number), data.x, data.y};
+                v1.events.append(PIXEL_TYPE, &v1_data, sizeof v1_data);
+            } else if (event.type == ELIMINATED_TYPE) {
+                eliminated_data_v2_mess data;
+                memcpy(&data, event.data, sizeof data);
+                eliminated_data_mess v1_data{(uint8_t) be16toh(data.player_number)};
+                v1.events.append(ELIMINATED_TYPE, &v1_data, sizeof v1_data);
+            } else if (event.type == END_GAME_TYPE) {
+                v1.events.append(END_GAME_TYPE, nullptr, 0);
+            }
+        }
+    }
 
+    // compact records of the v2 events not encoded yet, their numbers are the same
+    void make_compact_records() {
+        auto &compact = current_game.compact;
+        auto &v2 = current_game.stream(PROTOCOL_V2).events;
+        for (uint32_t &next = current_game.compact_made_until; next < v2.size(); next++) {
+            LoggedEvent event = v2.event(next);
+            if (event.type == NEW_GAME_TYPE) {
+                new_game_data_v2_mess data;
+                memcpy(&data, event.data, sizeof data);
+                compact.new_game(event.data, event.len, be32toh(data.players_count));
+            } else if (event.type == PLAYER_NAMES_TYPE) {
+                compact.player_names(event.data, event.len);
+            } else if (event.type == PIXEL_TYPE) {
+                pixel_data_v2_mess data;
+                memcpy(&data, event.data, sizeof data);
+                compact.pixel(be16toh(data.player_number), be32toh(data.x), be32toh(data.y));
+            } else if (event.type == ELIMINATED_TYPE) {
+                eliminated_data_v2_mess data;
+                memcpy(&data, event.data, sizeof data);
+                compact.eliminated(be16toh(data.player_number));
+            } else if (event.type == END_GAME_TYPE) {
+                compact.end_game();
+            }
+        }
+    }
 
-void generate_end_game() {
-    current_game.end_game();
+    //check if game is still going
+    bool still_playing(bool playing) {
+        if (!playing)
+            generate_end_game();
+        return playing;
+    }
 
-    current_game.events.emplace_back("", current_game.events.size(), END_GAME_TYPE);
-}
+    //true if game has NOT ended (technically possible)
+    bool start_game() {
+        current_game.clear();
+        for (uint32_t slot : players.connected())
+            players[slot].window.reset();
+        add_players();
+        current_game.game_id = rand_moodle();
+        generate_new_game();
+        generate_lockstep_new_game();
+        auto on_pixel = [this](uint32_t x, uint32_t y, uint32_t player_no) { generate_pixel(x, y, player_no); };
+        auto on_eliminated = [this](uint32_t player_no) { generate_player_eliminated(player_no); };
+        for (uint i = 0; i < current_game.players.size(); i++) {
+            uint32_t x = (rand_moodle() % maxx);
+            uint32_t y = (rand_moodle() % maxy);
+            int32_t direction = rand_moodle() % 360;
+            if (current_game.lockstep.kept)
+                current_game.lockstep.worm(x, y, direction);
+            place_worm(current_game.worms, current_game.board, x, y, direction,
+                       players[current_game.players[i]].turn_direction, current_game.active_players,
+                       on_pixel, on_eliminated);
+        }
+        bool result = still_playing(!game_over(current_game.active_players));
+        send_to_all_clients({});
+        return result;
+    }
 
-//check if game is still going
-bool still_playing() {
-    if (current_game.active_players == 1) {
-        generate_end_game();
-        return false;
+    //true if game has NOT ended
+    bool one_round() {
+        auto events_before = current_game.events_count();
+        auto &worms = current_game.worms;
+        auto &lockstep = current_game.lockstep;
+        // inputs are all lockstep clients need to play the round themselves
+        if (lockstep.kept)
+            lockstep.tick(worms.turn_direction);
+        bool result = play_round(worms, current_game.board, turning_speed, current_game.active_players,
+                                 [this](uint32_t x, uint32_t y, uint32_t player_no) {
+                                     generate_pixel(x, y, player_no);
+                                 },
+                                 [this](uint32_t player_no) { generate_player_eliminated(player_no); });
+        current_game.ticks++;
+        if (lockstep.kept && current_game.ticks % LOCKSTEP_HASH_INTERVAL == 0)
+            lockstep.hash(current_game.ticks, state_hash(worms));
+        result = still_playing(result);
+        send_to_all_clients(events_before);
+        return result;
+    }
+
+    [[nodiscard]] uint64_t next_deadline() const {
+        return schedule.next_deadline();
     }
-    return true;
-}
 
-//true if game has NOT ended (technically possible)
-bool start_game() {
-    current_game.clear();
-    add_players();
-    current_game.game_id = rand_moodle();
-    generate_new_game();
-    for (uint i = 0; i < current_game.players.size(); i++) {
-        auto &player_ptr = current_game.players[i];
-        auto &player = *player_ptr;
-        uint32_t x = (rand_moodle() % maxx);
-        uint32_t y = (rand_moodle() % maxy);
-        player.x = (double) x + 0.5;
-        player.y = (double) y + 0.5;
-        player.direction = rand_moodle() % 360;
-        if (current_game.board[x][y]) {
-            generate_player_eliminated(i);
+    //runs the room if its round is due, returns time of the next round
+    uint64_t step(uint64_t now) {
+        if (now < schedule.next_deadline())
+            return schedule.next_deadline();
+
+        if (playing) {
+            schedule.round_started(now);
+            playing = one_round();
+            schedule.round_finished(now, current_time_in_microseconds());
+        } else if (time_to_start()) {
+            playing = start_game();
+            schedule.restart(now);
         } else {
-            generate_pixel(x, y, i);
+            schedule.stop(); // until apply sees everybody ready
         }
+        return schedule.next_deadline();
     }
-    bool result = still_playing();
-    send_to_all_clients(0);
-    return result;
-}
-
-void move_player(PlayerData &p) {
 
-    if (p.turn_direction == 1)
-        p.direction += turning_speed;
-    if (p.turn_direction == 2)
-        p.direction -= turning_speed;
+    //prints counters of the room on stderr
+    void report() {
+        uint64_t cache_hits = 0, cache_misses = 0;
+        for (auto &stream : current_game.streams) {
+            cache_hits += stream.datagrams.hits;
+            cache_misses += stream.datagrams.misses;
+        }
+        cache_hits += current_game.compact.datagrams.hits + current_game.lockstep.datagrams.hits;
+        cache_misses += current_game.compact.datagrams.misses + current_game.lockstep.datagrams.misses;
+        cerr << "room " << room_no
+             << ": datagram cache hits " << cache_hits
+             << " misses " << cache_misses
+             << ", broadcast datagrams " << batch.datagrams
+             << " syscalls saved " << batch.datagrams - batch.syscalls
+             << " dropped " << batch.dropped + dropped
+             << ", resent " << resent
+             << " deferred " << deferred
+             << ", rounds " << schedule.rounds
+             << " late " << schedule.late
+             << " overrun " << schedule.overruns
+             << " skipped " << schedule.skipped
+             << " jitter avg " << (schedule.rounds ? schedule.jitter_sum / schedule.rounds : 0)
+             << "us max " << schedule.jitter_max << "us"
+             << ", heartbeats by shard";
+        for (auto &shard : shards)
+            cerr << " " << shard->heartbeats.load(memory_order_relaxed);
+        cerr << endl;
+    }
+};
 
-    p.direction = (p.direction) % 360;
+vector<unique_ptr<Room>> rooms{};
 
-    double direction_radians = (double) p.direction * DEG_TO_RADIANS;
-    p.x += cos(direction_radians);
-    p.y += sin(direction_radians);
+// applies updates to their rooms in order, leaves inputs empty
+void apply_inputs(InputBatch &inputs) {
+    size_t next_join = 0;
+    for (auto &update : inputs.updates)
+        update.room->apply(update, update.kind == InputKind::JOIN ? &inputs.joins[next_join++] : nullptr);
+    for (auto &update : inputs.updates)
+        update.room->start_if_ready();
+    inputs.clear();
 }
 
-//true if game has NOT ended
-bool one_round() {
-    size_t events_before = current_game.events.size();
-    for (uint i = 0; i < current_game.players.size(); i++) {
-        auto &player = *(current_game.players[i]);
-        if (player.eliminated)
-            continue;
-        uint32_t last_x = player.x;
-        uint32_t last_y = player.y;
-        move_player(player);
-        uint32_t x = player.x;
-        uint32_t y = player.y;
-        if (last_x == x && last_y == y)
-            continue;
-        else {
-            if (x >= maxx || y >= maxy || current_game.board[x][y])
-                generate_player_eliminated(i);
+// inputs from one shard thread to one worker, the worker takes them all at once
+struct alignas(64) InputQueue {
+    mutex mut{};
+    InputBatch batch{};
+};
+
+// Thread which ticks some rooms. With one shard per room it receives their heartbeats itself,
+// otherwise shard threads queue inputs for it and wake it up through wake_fd.
+struct Worker {
+    vector<Room *> rooms{};
+    int wake_fd;
+    vector<unique_ptr<InputQueue>> queues{}; // by shard
+
+    Worker() : wake_fd(eventfd(0, EFD_NONBLOCK)) {
+        if (wake_fd < 0)
+            syserr("eventfd");
+        for (uint64_t i = 0; i < shards_count; i++)
+            queues.push_back(make_unique<InputQueue>());
+    }
+
+    // called by the shard's thread, leaves inputs empty
+    void queue(size_t shard, InputBatch &inputs) {
+        auto &queue = *queues[shard];
+        bool was_empty;
+        {
+            lock_guard<mutex> lock(queue.mut);
+            was_empty = queue.batch.empty();
+            if (was_empty)
+                swap(queue.batch, inputs); // inputs gets the buffers the worker has emptied
             else
-                generate_pixel(x, y, i);
+                queue.batch.append(inputs);
         }
-        if (!still_playing()) {
-            send_to_all_clients(events_before);
-            return false;
+        uint64_t one = 1;
+        if (was_empty && write(wake_fd, &one, sizeof one) < 0 && errno != EAGAIN)
+            syserr("write");
+    }
+
+    // applies what all shards have queued, inputs must be empty
+    void apply_queued(InputBatch &inputs) {
+        for (auto &queue : queues) {
+            {
+                lock_guard<mutex> lock(queue->mut);
+                swap(queue->batch, inputs);
+            }
+            apply_inputs(inputs);
+        }
+    }
+};
+
+vector<unique_ptr<Worker>> workers{};
+
+// Loop of a worker, multiplexing the sockets of its rooms (or the wake ups from shard threads)
+// and a timer with epoll. Heartbeats are applied as they come and once more right before every
+// round, whose events are sent right after it, so rounds see all input received.
+[[noreturn]] void do_reactor(Worker &worker) {
+    auto &my_rooms = worker.rooms;
+    int epoll_fd = epoll_create1(0);
+    if (epoll_fd < 0)
+        syserr("epoll_create1");
+    int timer_fd = timerfd_create(CLOCK_MONOTONIC, 0);
+    if (timer_fd < 0)
+        syserr("timerfd_create");
+
+    // epoll data is the index of the room, then come the wake ups and the timer
+    bool own_sockets = shards_count == 1;
+    size_t wake_source = my_rooms.size(), timer_source = my_rooms.size() + 1;
+    for (size_t i = own_sockets ? 0 : wake_source; i <= timer_source; i++) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = i;
+        int fd = i < wake_source ? my_rooms[i]->sock_fd : i == wake_source ? worker.wake_fd : timer_fd;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0)
+            syserr("epoll_ctl");
+    }
+
+    auto buffers = make_unique<ReceiveBuffers>();
+    InputBatch inputs;
+    epoll_event events[RECEIVE_BATCH];
+    uint64_t next_report = current_time_in_microseconds() + report_interval * 1000000;
+    uint64_t next_expiry = current_time_in_microseconds() + IDLE_WHEEL_RESOLUTION;
+    for (;;) {
+        if (!own_sockets)
+            worker.apply_queued(inputs);
+        uint64_t now = current_time_in_microseconds();
+        uint64_t next_round = UINT64_MAX;
+        bool expire = own_sockets && now >= next_expiry, any_connections = false;
+        for (auto *room : my_rooms) {
+            if (own_sockets) {
+                auto &shard = *room->shards[0];
+                if (now >= room->next_deadline())
+                    shard.drain(*buffers, inputs);
+                if (expire && shard.connections.size() != 0)
+                    shard.disconnect_old(now, inputs);
+                apply_inputs(inputs);
+                any_connections = any_connections || shard.connections.size() != 0;
+            }
+            next_round = min(next_round, room->step(now));
+        }
+        if (expire)
+            next_expiry = now + IDLE_WHEEL_RESOLUTION;
+
+        if (report_interval != 0 && now >= next_report) {
+            for (auto *room : my_rooms)
+                room->report();
+            next_report = now + report_interval * 1000000;
+        }
+
+        // absolute time, 0 disarms the timer while all rooms are idle and empty
+        uint64_t wake_up = min(next_round, report_interval != 0 ? next_report : UINT64_MAX);
+        if (any_connections)
+            wake_up = min(wake_up, next_expiry);
+        itimerspec timer{};
+        if (wake_up != UINT64_MAX) {
+            wake_up = max<uint64_t>(1, wake_up);
+            timer.it_value.tv_sec = wake_up / 1000000;
+            timer.it_value.tv_nsec = (wake_up % 1000000) * 1000;
+        }
+        if (timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &timer, nullptr) < 0)
+            syserr("timerfd_settime");
+
+        int ready = epoll_wait(epoll_fd, events, RECEIVE_BATCH, -1);
+        if (ready < 0 && errno != EINTR)
+            syserr("epoll_wait");
+        for (int i = 0; i < ready; i++) {
+            size_t source = events[i].data.u64;
+            if (source < wake_source) {
+                my_rooms[source]->shards[0]->drain(*buffers, inputs);
+                apply_inputs(inputs);
+            } else {
+                // wake ups are applied at the top of the loop
+                uint64_t expirations;
+                if (read(source == wake_source ? worker.wake_fd : timer_fd, &expirations, sizeof expirations) < 0 &&
+                    errno != EAGAIN)
+                    syserr("read");
+            }
         }
     }
-    send_to_all_clients(events_before);
-    return true;
 }
 
-//waits till the end of turn
-void wait_to_end(uint64_t last_start, uint64_t time_per_round) {
-    uint64_t time_passed = current_time_in_microseconds() - last_start;
-    if (time_passed < time_per_round)
-        usleep((time_per_round - time_passed));
+// worker pinned to a core, runs its rooms in a reactor loop
+[[noreturn]] void do_worker(Worker *worker, unsigned cpu) {
+    pin_to_cpu(cpu);
+    do_reactor(*worker);
 }
 
-// simulates rounds in loop
-[[noreturn]] void do_rounds() {
-    uint64_t last_start;
-    uint64_t time_per_round = 1000000 / rounds_per_second;
+// Thread of one shard of every room: receives on the shard's socket of each room and queues what
+// it gets for the room's worker. Connections which say nothing are timed out every wheel slot.
+[[noreturn]] void do_shard(size_t shard) {
+    if (steer_by_cpu)
+        pin_to_cpu(shard % max(1u, thread::hardware_concurrency()));
+    int epoll_fd = epoll_create1(0);
+    if (epoll_fd < 0)
+        syserr("epoll_create1");
+    for (size_t i = 0; i < rooms.size(); i++) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = i;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, rooms[i]->shards[shard]->sock_fd, &event) < 0)
+            syserr("epoll_ctl");
+    }
 
-    unique_lock<mutex> waiting_for_players(wait_for_players_mut);
+    auto buffers = make_unique<ReceiveBuffers>();
+    vector<InputBatch> outgoing(workers.size()); // by worker
+    epoll_event events[RECEIVE_BATCH];
+    uint64_t next_expiry = current_time_in_microseconds() + IDLE_WHEEL_RESOLUTION;
+    bool any_connections = false;
     for (;;) {
-        wait_for_players.wait(waiting_for_players, time_to_start);
-        last_start = current_time_in_microseconds();
-        {
-            lock_guard<mutex> lock(mut);
-            if (!start_game())
-                continue;
+        uint64_t now = current_time_in_microseconds();
+        int timeout = !any_connections ? -1 : now >= next_expiry ? 0 : (int) ((next_expiry - now + 999) / 1000);
+        int ready = epoll_wait(epoll_fd, events, RECEIVE_BATCH, timeout);
+        if (ready < 0 && errno != EINTR)
+            syserr("epoll_wait");
+        for (int i = 0; i < ready; i++) {
+            auto &room = *rooms[events[i].data.u64];
+            room.shards[shard]->drain(*buffers, outgoing[room.worker_no]);
         }
-        wait_to_end(last_start, time_per_round);
-        for (;;) {
-            last_start = current_time_in_microseconds();
-            {
-                lock_guard<mutex> lock(mut);
-                disconnect_old(current_time_in_microseconds());
-                if (!one_round()) {
-                    break;
-                }
+
+        any_connections = any_connections || ready > 0;
+
+        // without connections in any room the thread sleeps until a datagram comes
+        now = current_time_in_microseconds();
+        if (any_connections && now >= next_expiry) {
+            any_connections = false;
+            for (auto &room : rooms) {
+                auto &room_shard = *room->shards[shard];
+                if (room_shard.connections.size() != 0)
+                    room_shard.disconnect_old(now, outgoing[room->worker_no]);
+                any_connections = any_connections || room_shard.connections.size() != 0;
             }
-            wait_to_end(last_start, time_per_round);
+            next_expiry = now + IDLE_WHEEL_RESOLUTION;
         }
+        for (size_t i = 0; i < workers.size(); i++)
+            if (!outgoing[i].empty())
+                workers[i]->queue(shard, outgoing[i]);
     }
 }
 
+void init_rooms() {
+    uint64_t seed = random_value;
+    for (uint32_t i = 0; i < rooms_count; i++)
+        rooms.push_back(make_unique<Room>(i, rand_moodle(seed)));
+}
+
 int main(int argc, char **argv) {
-    ready_players = connected_players = 0;
     parse_options(argc, argv);
     validity_check();
-    init_socket();
-    thread listener(do_listen);
-    do_rounds();
-    listener.join();
-    if (close(sock_fd) != 0) syserr("close");
-    return 0;
+    EventLog::resident_limit = (log_memory * 1024 * 1024 + EVENT_LOG_BLOCK_SIZE - 1) / EVENT_LOG_BLOCK_SIZE;
+    init_rooms();
+
+    unsigned cores = max(1u, thread::hardware_concurrency());
+    if (reactor)
+        workers_count = 1;
+    if (workers_count == 0)
+        workers_count = min<uint64_t>(cores, rooms_count);
+    workers_count = min(workers_count, rooms_count);
+
+    // rooms are dealt to workers round robin, worker i is pinned to core i
+    for (uint64_t i = 0; i < workers_count; i++)
+        workers.push_back(make_unique<Worker>());
+    for (size_t i = 0; i < rooms.size(); i++) {
+        rooms[i]->worker_no = i % workers_count;
+        workers[i % workers_count]->rooms.push_back(rooms[i].get());
+    }
+
+    vector<thread> threads;
+    if (shards_count > 1)
+        for (size_t shard = 0; shard < shards_count; shard++)
+            threads.emplace_back(do_shard, shard);
+    for (unsigned i = 1; i < workers_count; i++)
+        threads.emplace_back(do_worker, workers[i].get(), i % cores);
+    if (reactor)
+        do_reactor(*workers[0]);
+    do_worker(workers[0].get(), 0);
 }